@@ -0,0 +1,45 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef BENCH_INCLUDED
+#define BENCH_INCLUDED
+
+// STL
+#include <cstdio>
+
+// C++11
+#include <chrono>
+
+#include <stdint.h>
+
+/**
+ * @file Timing helpers of the benchmarks in bench/
+ *
+ */
+
+namespace EJV
+{
+    namespace Bench
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        /** Nanoseconds per operation between start and now */
+        inline double nsPerOp(Clock::time_point start, uint64_t operations)
+        {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+        }
+
+        /** Keeps the compiler from dropping work whose result isn't used */
+        inline void keep(uint64_t value)
+        {
+            static volatile uint64_t sink;
+
+            sink = sink + value;
+        }
+    }
+}
+
+#endif //BENCH_INCLUDED
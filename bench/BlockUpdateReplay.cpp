@@ -0,0 +1,210 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#include "Bench.hpp"
+
+#include "GlobalState.hpp"
+
+// STL
+#include <fstream>
+#include <vector>
+
+// C++11
+#include <random>
+
+/**
+ * @file Replays a recorded set of block updates serially and in parallel
+ *
+ * Usage: BlockUpdateReplay [file]
+ *
+ * The file holds one scheduled update per line as
+ * "tick x y z delay priority", in tick order. Without a file a seeded
+ * set is recorded instead. Both runs schedule the set into identical
+ * worlds and must end with the same blocks, or the program exits with 1.
+ *
+ * The area is loaded up front: parallel passes hold back the updates
+ * reaching unloaded chunks until the workers loaded them
+ * (World::deferUnloadedReach), so results only match on resident chunks.
+ */
+
+using namespace EJV;
+
+namespace
+{
+    struct Recorded
+    {
+        uint64_t tick; // When scheduleUpdate is called
+
+        Point3D block;
+
+        unsigned int delay;
+
+        int priority;
+    };
+
+    typedef std::vector<Recorded> RecordList;
+
+    const int EXTENT = 100;  // Blocks scheduled in [-EXTENT, EXTENT) horizontally
+    const int DEPTH = 32;    // and [-DEPTH, DEPTH) vertically
+
+    const uint64_t TICKS = 8;
+
+    const int MARGIN = 16; // Blocks beyond the scheduled ones the updates reach
+
+    const Chunk::BlockID TYPES = 4;
+
+    void record(RecordList& updates)
+    {
+        std::mt19937 random(5);
+
+        for (uint64_t tick = 1; tick <= TICKS; ++tick)
+        {
+            for (unsigned int i = 0; i < 3000; ++i)
+            {
+                Recorded update = { tick, Point3D(int(random() % (2 * EXTENT)) - EXTENT, int(random() % (2 * DEPTH)) - DEPTH,
+                                                  int(random() % (2 * EXTENT)) - EXTENT), unsigned(random() % 3), int(random() % 3) - 1 };
+
+                updates.push_back(update);
+            }
+        }
+    }
+
+    bool read(const char* path, RecordList& updates)
+    {
+        std::ifstream file(path);
+
+        Recorded update;
+
+        while (file >> update.tick >> update.block.x >> update.block.y >> update.block.z >> update.delay >> update.priority)
+        {
+            updates.push_back(update);
+        }
+
+        return file.eof();
+    }
+
+    // Reads and writes a neighbour, and sometimes schedules the block above (up to DEPTH)
+    void updateBlock(World* world, const Point3D& block, BlockInfo&)
+    {
+        const Point3D neighbour(block.x + 1, block.y, block.z - 1);
+
+        const Chunk::BlockID id = world->getBlock(neighbour);
+
+        world->setBlock(neighbour, (id * 7 + 3) % TYPES);
+
+        const Chunk::BlockID above = world->getBlock(Point3D(block.x, block.y + 1, block.z));
+
+        world->setBlock(block, (above + 1) % TYPES);
+
+        if (above == 0 && block.y < DEPTH) world->scheduleUpdate(Point3D(block.x, block.y + 1, block.z), 1);
+    }
+
+    Chunk* generateChunk(int, int y, int)
+    {
+        return Chunk::getShared(y < 0 ? 1 : 0);
+    }
+
+    Chunk* loadChunk(int, int, int) { return 0; }
+
+    void putChunk(int, int, int, Chunk*) {}
+
+    /** Replays the updates and returns a hash of the blocks around them */
+    uint64_t replay(const RecordList& updates, bool parallel)
+    {
+        World world("replay");
+
+        LoaderModule loader;
+        GeneratorModule generator;
+
+        loader.loadChunk = loadChunk;
+        loader.putChunk = putChunk;
+        loader.releaseChunk = 0;
+
+        generator.generateChunk = generateChunk;
+
+        world.loader = &loader;
+        world.generator = &generator;
+
+        world.blockUpdates.setParallel(parallel);
+        world.blockUpdates.setParallelThreshold(1);
+
+        for (int x = (-EXTENT - MARGIN) / CHUNK_WIDTH - 1; x <= (EXTENT + MARGIN) / CHUNK_WIDTH; ++x)
+            for (int y = (-DEPTH - MARGIN) / CHUNK_HEIGHT - 1; y <= (DEPTH + MARGIN) / CHUNK_HEIGHT; ++y)
+                for (int z = (-EXTENT - MARGIN) / CHUNK_LENGTH - 1; z <= (EXTENT + MARGIN) / CHUNK_LENGTH; ++z) world.loadChunk(Point3D(x, y, z));
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        RecordList::const_iterator it = updates.begin();
+
+        unsigned int regions = 0;
+
+        while (it != updates.end() || !world.deferredUpdates.empty() || !world.updateTickets.empty())
+        {
+            ++world.ticks;
+
+            for (; it != updates.end() && it->tick <= world.ticks; ++it) world.scheduleUpdate(it->block, it->delay, it->priority);
+
+            world.update();
+
+            regions += world.blockUpdates.getStats().regions;
+        }
+
+        const double time = Bench::nsPerOp(start, 1) / 1000000;
+
+        uint64_t hash = 0;
+
+        for (int x = -EXTENT - MARGIN; x < EXTENT + MARGIN; ++x)
+            for (int y = -DEPTH - MARGIN; y < DEPTH + MARGIN; ++y)
+                for (int z = -EXTENT - MARGIN; z < EXTENT + MARGIN; ++z) hash = hash * 31 + world.getBlock(Point3D(x, y, z));
+
+        std::printf("%-8s %8.1f ms  %llu ticks  %u regions  hash %016llx\n", parallel ? "parallel" : "serial", time,
+                    (unsigned long long) world.ticks, regions, (unsigned long long) hash);
+
+        return hash;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    RecordList updates;
+
+    if (argc > 1)
+    {
+        if (!read(argv[1], updates))
+        {
+            std::printf("Unable to read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        record(updates);
+    }
+
+    State& core = State::GET();
+
+    for (Chunk::BlockID id = 0; id < TYPES; ++id)
+    {
+        BlockInfo info(1.0);
+
+        info.updateFunc = updateBlock;
+
+        core.registerBlock(info);
+    }
+
+    std::printf("%u recorded updates\n", unsigned(updates.size()));
+
+    const uint64_t serial = replay(updates, false);
+    const uint64_t parallel = replay(updates, true);
+
+    if (serial != parallel)
+    {
+        std::printf("Parallel updates diverged from the serial ones\n");
+        return 1;
+    }
+
+    return 0;
+}
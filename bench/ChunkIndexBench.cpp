@@ -0,0 +1,127 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#include "Bench.hpp"
+
+#include "ChunkIndex.hpp"
+
+// STL
+#include <algorithm>
+#include <map>
+#include <vector>
+
+// C++11
+#include <random>
+
+/**
+ * @file ChunkIndex against the std::map it replaced
+ *
+ * Inserts n chunk positions (16 sections high, square around the
+ * origin), looks each up in random order, then erases them, and
+ * prints nanoseconds per operation for both containers.
+ */
+
+using namespace EJV;
+
+namespace
+{
+    const unsigned int LOOKUP_PASSES = 5;
+
+    void fillPoints(unsigned int count, std::vector<Point3D>& points)
+    {
+        int side = 1;
+
+        while (side * side * 16 < int(count)) ++side;
+
+        for (int x = 0; x < side; ++x)
+            for (int z = 0; z < side; ++z)
+                for (int y = 0; y < 16 && points.size() < count; ++y)
+                    points.push_back(Point3D(x - side / 2, y, z - side / 2));
+    }
+
+    void benchIndex(const std::vector<Point3D>& points, const std::vector<Point3D>& shuffled)
+    {
+        ChunkIndex index;
+
+        Chunk* chunk = Chunk::getShared(0);
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        for (std::vector<Point3D>::const_iterator it = points.begin(); it != points.end(); ++it) index.insert(*it, chunk);
+
+        const double insert = Bench::nsPerOp(start, points.size());
+
+        start = Bench::Clock::now();
+
+        for (unsigned int pass = 0; pass < LOOKUP_PASSES; ++pass)
+        {
+            for (std::vector<Point3D>::const_iterator it = shuffled.begin(); it != shuffled.end(); ++it) Bench::keep(uintptr_t(index.find(*it)));
+        }
+
+        const double lookup = Bench::nsPerOp(start, uint64_t(shuffled.size()) * LOOKUP_PASSES);
+
+        start = Bench::Clock::now();
+
+        for (std::vector<Point3D>::const_iterator it = shuffled.begin(); it != shuffled.end(); ++it) index.erase(*it);
+
+        const double erase = Bench::nsPerOp(start, shuffled.size());
+
+        std::printf("%8u chunks  ChunkIndex  insert %6.1f  lookup %6.1f  erase %6.1f ns\n", unsigned(points.size()), insert, lookup, erase);
+    }
+
+    void benchMap(const std::vector<Point3D>& points, const std::vector<Point3D>& shuffled)
+    {
+        std::map<Point3D, Chunk*> map;
+
+        Chunk* chunk = Chunk::getShared(0);
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        for (std::vector<Point3D>::const_iterator it = points.begin(); it != points.end(); ++it) map[*it] = chunk;
+
+        const double insert = Bench::nsPerOp(start, points.size());
+
+        start = Bench::Clock::now();
+
+        for (unsigned int pass = 0; pass < LOOKUP_PASSES; ++pass)
+        {
+            for (std::vector<Point3D>::const_iterator it = shuffled.begin(); it != shuffled.end(); ++it) Bench::keep(uintptr_t(map.find(*it)->second));
+        }
+
+        const double lookup = Bench::nsPerOp(start, uint64_t(shuffled.size()) * LOOKUP_PASSES);
+
+        start = Bench::Clock::now();
+
+        for (std::vector<Point3D>::const_iterator it = shuffled.begin(); it != shuffled.end(); ++it) map.erase(*it);
+
+        const double erase = Bench::nsPerOp(start, shuffled.size());
+
+        std::printf("%8u chunks  std::map    insert %6.1f  lookup %6.1f  erase %6.1f ns\n", unsigned(points.size()), insert, lookup, erase);
+    }
+}
+
+int main()
+{
+    const unsigned int counts[] = { 10000, 100000, 1000000 };
+
+    std::mt19937 random(1);
+
+    for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+    {
+        std::vector<Point3D> points;
+
+        fillPoints(counts[i], points);
+
+        std::vector<Point3D> shuffled(points);
+
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
+
+        benchIndex(points, shuffled);
+        benchMap(points, shuffled);
+    }
+
+    return 0;
+}
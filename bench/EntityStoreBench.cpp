@@ -0,0 +1,128 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#include "Bench.hpp"
+
+#include "EntityStore.hpp"
+
+// C++11
+#include <random>
+
+/**
+ * @file EntityStore::integrate against a scalar loop
+ *
+ * Times the store's integrate (AVX or SSE2, whichever the core was
+ * built with) and the same motion as a plain loop the compiler must
+ * not vectorize, at 10k and 100k entities. Both must end up at the
+ * same state.
+ */
+
+using namespace EJV;
+
+namespace
+{
+    const unsigned int STEPS = 10000000; // Entity updates per measurement
+
+    /** EntityStore::integrate without SIMD */
+    __attribute__((optimize("no-tree-vectorize")))
+    void integrateScalar(EntityStore& store)
+    {
+        const unsigned int count = store.size();
+
+        double* posX = store.posX();
+        double* posY = store.posY();
+        double* posZ = store.posZ();
+
+        double* velX = store.velX();
+        double* velY = store.velY();
+        double* velZ = store.velZ();
+
+        const double* gravity = store.gravity();
+        const double* drag = store.drag();
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            posX[i] += velX[i];
+            posY[i] += velY[i];
+            posZ[i] += velZ[i];
+
+            velX[i] *= drag[i];
+            velY[i] = (velY[i] - gravity[i]) * drag[i];
+            velZ[i] *= drag[i];
+        }
+    }
+
+    void fill(EntityStore& store, unsigned int count)
+    {
+        std::mt19937 random(1);
+
+        std::uniform_real_distribution<double> position(-1000, 1000), velocity(-1, 1);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            EntityHandle entity = store.create(1, position(random), position(random), position(random), 0.08, 0.98);
+
+            const unsigned int index = store.find(entity);
+
+            store.velX()[index] = velocity(random);
+            store.velY()[index] = velocity(random);
+            store.velZ()[index] = velocity(random);
+        }
+    }
+
+    /** Returns how many entities differ between the two */
+    unsigned int run(unsigned int count)
+    {
+        EntityStore simd, scalar;
+
+        fill(simd, count);
+        fill(scalar, count);
+
+        const unsigned int ticks = STEPS / count;
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        for (unsigned int tick = 0; tick < ticks; ++tick) simd.integrate();
+
+        const double simdTime = Bench::nsPerOp(start, uint64_t(ticks) * count);
+
+        start = Bench::Clock::now();
+
+        for (unsigned int tick = 0; tick < ticks; ++tick) integrateScalar(scalar);
+
+        const double scalarTime = Bench::nsPerOp(start, uint64_t(ticks) * count);
+
+        unsigned int mismatches = 0;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (simd.posX()[i] != scalar.posX()[i] || simd.posY()[i] != scalar.posY()[i] || simd.posZ()[i] != scalar.posZ()[i] ||
+                simd.velY()[i] != scalar.velY()[i]) ++mismatches;
+        }
+
+        std::printf("%7u entities  integrate %5.2f  scalar %5.2f ns/entity  (%.2fx, %u mismatches)\n", count, simdTime, scalarTime,
+                    scalarTime / simdTime, mismatches);
+
+        return mismatches;
+    }
+}
+
+int main()
+{
+#if defined(__AVX__)
+    std::printf("Built for AVX\n");
+#elif defined(__SSE2__)
+    std::printf("Built for SSE2\n");
+#else
+    std::printf("Built without SIMD\n");
+#endif
+
+    unsigned int mismatches = run(10000);
+
+    mismatches += run(100000);
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#include "Bench.hpp"
+
+#include "GlobalState.hpp"
+
+/**
+ * @file World::takeRandomTicks over 10k ticking sections
+ *
+ * Loads 50 x 4 x 50 sections under one ticking ticket and times the
+ * random tick pick per tick, once with a tenth of the sections holding
+ * a random ticking block and once with all of them.
+ */
+
+using namespace EJV;
+
+namespace
+{
+    const int SIDE = 50;
+    const int HEIGHT = 4;
+
+    const unsigned int TICKS = 200;
+
+    const Chunk::BlockID STONE = 1;
+    const Chunk::BlockID GRASS = 2; // Takes random ticks
+
+    unsigned int tickableEvery = 10; // One section in that many has grass
+
+    Chunk* generateChunk(int x, int y, int z)
+    {
+        Chunk* chunk = new Chunk(STONE);
+
+        if (unsigned(x * 7 + z * 3 + y) % tickableEvery == 0) chunk->setBlock(1, 1, 1, GRASS);
+
+        return chunk;
+    }
+
+    Chunk* loadChunk(int, int, int) { return 0; }
+
+    void putChunk(int, int, int, Chunk*) {}
+
+    void run(const char* name)
+    {
+        World world("bench");
+
+        LoaderModule loader;
+        GeneratorModule generator;
+
+        loader.loadChunk = loadChunk;
+        loader.putChunk = putChunk;
+        loader.releaseChunk = 0;
+
+        generator.generateChunk = generateChunk;
+
+        world.loader = &loader;
+        world.generator = &generator;
+
+        // Ticket the sections without requesting the whole cube it covers
+        ChunkTickets::PointList covered;
+
+        world.tickets.acquire(TICKET_PLUGIN, TICKET_LEVEL_TICKING, Point3D(0, 0, 0), SIDE / 2, 0, covered);
+
+        for (int x = -SIDE / 2; x < SIDE / 2; ++x)
+            for (int z = -SIDE / 2; z < SIDE / 2; ++z)
+                for (int y = 0; y < HEIGHT; ++y) world.getChunk(Point3D(x, y, z));
+
+        BlockUpdateScheduler::BlockList blocks;
+
+        uint64_t picked = 0;
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        for (unsigned int tick = 0; tick < TICKS; ++tick)
+        {
+            ++world.ticks;
+
+            blocks.clear();
+
+            world.takeRandomTicks(blocks);
+
+            picked += blocks.size();
+        }
+
+        const double perTick = Bench::nsPerOp(start, TICKS) / 1000;
+
+        const RandomTicker::Stats& stats = world.randomTicker.getStats();
+
+        std::printf("%-24s %u sections  %8.1f us/tick  skipped %u  picked %.1f/tick\n", name, unsigned(world.loadedChunks.size()), perTick,
+                    stats.skipped, double(picked) / TICKS);
+    }
+}
+
+int main()
+{
+    State& core = State::GET();
+
+    BlockInfo air, stone(1.5), grass(0.6, true);
+
+    core.registerBlock(air);
+    core.registerBlock(stone);
+    core.registerBlock(grass);
+
+    tickableEvery = 10;
+
+    run("1 in 10 tickable");
+
+    tickableEvery = 1;
+
+    run("all tickable");
+
+    return 0;
+}
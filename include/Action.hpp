@@ -32,6 +32,13 @@ namespace EJV
 		ACTION_COUNT
 	};
 
+	/** Set of action types, one bit per ActionType */
+	typedef unsigned int ActionMask;
+
+	const ActionMask ACTION_MASK_ALL = (1u << ACTION_COUNT) - 1;
+
+	inline ActionMask actionBit(ActionType type) { return 1u << type; }
+
 	enum ItemUseType
 	{
 		ITEM_USE_PRIMARY,
@@ -58,12 +65,17 @@ namespace EJV
 
 	namespace Action
     {
+        /**
+         * Actions live in the State's ActionArena until the tick that
+         * dispatched them ends, they are released without running
+         * destructors: keep them trivially destructible and put any
+         * payload in the arena as well.
+         */
         struct Base
         {
             const ActionType type;
 
             inline Base(ActionType t) : type(t >= ACTION_COUNT ? ACTION_UNKNOWN : t) {}
-
             // TODO: Add more info (like player, world e.t.c.)
         };
 
@@ -78,7 +90,7 @@ namespace EJV
         {
             const unsigned short newSlot;
 
-            inline ItemChange(unsigned short _newSlot) : Base(ACTION_ITEM_USE), newSlot(_newSlot) {}
+            inline ItemChange(unsigned short _newSlot) : Base(ACTION_ITEM_CHANGE), newSlot(_newSlot) {}
         };
 
         struct KeyPress : public Base
@@ -95,9 +107,9 @@ namespace EJV
 
         struct Chat : public Base
         {
-            const std::string message;
+            const char* const message; // NUL terminated, see ActionArena::Writer::copy
 
-            inline Chat(const std::string& _message) : Base(ACTION_CHAT), message(_message) {}
+            inline Chat(const char* _message) : Base(ACTION_CHAT), message(_message) {}
         };
     }
 }
@@ -0,0 +1,155 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef ACTIONARENA_INCLUDED
+#define ACTIONARENA_INCLUDED
+
+// STL
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <stdint.h>
+
+// C++11
+#include <atomic>
+#include <mutex>
+
+/**
+ * @file Per tick memory for actions
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Memory for the actions of a tick, released in bulk once they were
+     * dispatched.
+     *
+     * The arena has two halves. Producers allocate from the current one
+     * through a Writer, which keeps the half pinned until the action was
+     * pushed. At the start of a tick the tick thread flips the halves and
+     * waits for writers still on the old one, every action of that half
+     * is queued by then. After dispatching it releases the old half.
+     *
+     * Allocation bumps an atomic offset in the current block of the half,
+     * only switching blocks takes a lock. Released blocks are kept for
+     * reuse, so a steady stream of actions doesn't reach malloc at all.
+     * Destructors are never run, arena objects must not own memory.
+     */
+    class ActionArena
+    {
+        protected:
+            struct Block;
+            struct Half;
+
+        public:
+            static const size_t BLOCK_SIZE = 64 * 1024;
+
+            struct Stats
+            {
+                uint64_t allocations;
+                uint64_t bytes;       // Including alignment
+                uint64_t blocks;      // Blocks taken from the system
+                uint64_t large;       // Allocations too large for a block
+            };
+
+            /** Pins the half producers currently fill, see the class description */
+            class Writer
+            {
+                public:
+                    Writer(ActionArena& arena) : _arena(arena), _half(arena.pin()) {}
+
+                    ~Writer() { _arena.unpin(_half); }
+
+                    /** Memory aligned for any action, valid until the half is released */
+                    void* allocate(size_t size) { return _arena.allocate(*_half, size); }
+
+                    /** Constructs an action in the arena */
+                    template <typename T, typename... Args>
+                    T* make(Args&&... args)
+                    {
+                        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+
+                        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+                    }
+
+                    /** Copies a string into the arena, NUL terminated */
+                    const char* copy(const std::string& text);
+
+                    const ActionArena& getArena() const { return _arena; }
+
+                protected:
+                    ActionArena& _arena;
+
+                    Half* _half;
+
+                private:
+                    Writer(const Writer& orig);
+                    Writer& operator=(const Writer& orig);
+            };
+
+            ActionArena();
+
+            ~ActionArena();
+
+            /** Tick thread: moves producers to the other half and waits for the writers left on this one */
+            void flip();
+
+            /** Tick thread: frees everything allocated in the half flipped away from */
+            void release();
+
+            Stats getStats() const;
+
+        protected:
+            struct Block
+            {
+                char data[BLOCK_SIZE];
+
+                std::atomic<size_t> used;
+            };
+
+            struct Half
+            {
+                std::atomic<Block*> current;
+
+                std::atomic<unsigned int> writers;
+
+                std::vector<Block*> full;   // Guarded by _mutex
+                std::vector<char*>  large;  // Guarded by _mutex
+            };
+
+            Half _halves[2];
+
+            std::atomic<unsigned int> _filling; // Index of the half producers allocate from
+
+            std::vector<Block*> _spare; // Guarded by _mutex
+
+            std::atomic<uint64_t> _allocations;
+            std::atomic<uint64_t> _bytes;
+            std::atomic<uint64_t> _blocks;
+            std::atomic<uint64_t> _large;
+
+            std::mutex _mutex;
+
+            Half* pin();
+            void unpin(Half* half);
+
+            void* allocate(Half& half, size_t size);
+
+            /** Spare block or a new one, _mutex held */
+            Block* takeBlock();
+
+        private:
+            ActionArena(const ActionArena& orig);
+            ActionArena& operator=(const ActionArena& orig);
+    };
+}
+
+#endif //ACTIONARENA_INCLUDED
@@ -0,0 +1,109 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef ACTIONQUEUE_INCLUDED
+#define ACTIONQUEUE_INCLUDED
+
+#include "Action.hpp"
+
+// STL
+#include <vector>
+
+#include <stdint.h>
+
+// C++11
+#include <atomic>
+#include <memory>
+
+/**
+ * @file Player actions handed to the tick thread
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Bounded lock-free queue of actions from any number of threads (UI
+     * modules, network threads) to the tick thread.
+     *
+     * Every slot of the ring carries a sequence number telling whether it
+     * is free or holds an action for a given position. Producers claim a
+     * position with a CAS on the tail and publish the slot afterwards; a
+     * full ring makes push() fail instead of blocking or allocating.
+     *
+     * The queue doesn't own the actions, they live in the ActionArena.
+     */
+    class ActionQueue
+    {
+        public:
+            typedef std::vector<Action::Base*> ActionList;
+
+            struct Stats
+            {
+                uint64_t pushed;
+                uint64_t rejected; // Pushes refused because the queue was full
+                uint64_t drained;
+            };
+
+            /** Capacity is rounded up to a power of two */
+            ActionQueue(unsigned int capacity = 4096);
+
+            /** Any thread: queues an action, false if the queue is full */
+            bool push(Action::Base* action);
+
+            /**
+             * Tick thread: moves the actions queued before the call to the
+             * list, in push order. Actions pushed meanwhile wait for the
+             * next drain, pushes already claimed are waited for. Returns
+             * the number of actions taken.
+             */
+            unsigned int drain(ActionList& actions);
+
+            unsigned int getCapacity() const { return _mask + 1; }
+
+            /** Actions waiting, approximate while producers push */
+            unsigned int size() const
+            {
+                const uint64_t head = _head.load(std::memory_order_acquire);
+
+                return _tail.load(std::memory_order_acquire) - head;
+            }
+
+            Stats getStats() const;
+
+        protected:
+            struct Slot
+            {
+                std::atomic<uint64_t> sequence; // Position + 1 once filled, position + capacity once free again
+
+                Action::Base* action;
+            };
+
+            std::unique_ptr<Slot[]> _slots;
+
+            const uint64_t _mask;
+
+            // Producers and the consumer each get their own cache line
+            char _padding0[64];
+
+            std::atomic<uint64_t> _tail; // Next position to claim
+
+            std::atomic<uint64_t> _pushed;
+            std::atomic<uint64_t> _rejected;
+
+            char _padding1[64];
+
+            std::atomic<uint64_t> _head; // Next position to drain, written by the consumer only
+
+            std::atomic<uint64_t> _drained;
+
+        private:
+            ActionQueue(const ActionQueue& orig);
+            ActionQueue& operator=(const ActionQueue& orig);
+    };
+}
+
+#endif //ACTIONQUEUE_INCLUDED
@@ -0,0 +1,154 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef AUTOSAVER_INCLUDED
+#define AUTOSAVER_INCLUDED
+
+#include "Chunk.hpp"
+#include "ChunkIndex.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// C++11
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <stdint.h>
+
+/**
+ * @file Background saving of dirty chunks
+ *
+ */
+
+namespace EJV
+{
+    struct World;
+
+    /**
+     * Periodically saves a world's dirty chunks without stalling ticks.
+     *
+     * Every interval a save cycle lists the dirty chunks. Each tick copies
+     * as many of them as fit in the time budget and queues the copies for
+     * a writer thread, which puts them through the loader. Chunks are only
+     * marked saved once their copy is written.
+     */
+    class AutoSaver
+    {
+        public:
+            struct Stats
+            {
+                uint64_t snapshots; // Chunks copied for saving
+                uint64_t written;   // Copies written by the loader
+                uint64_t cancelled; // Copies dropped because their chunk was saved or unloaded first
+                uint64_t failed;    // Copies the loader threw on, their chunks stay dirty
+
+                unsigned int remaining; // Dirty chunks of the current cycle not copied yet
+                unsigned int backlog;   // Copies waiting for the writer
+
+                double writeRate; // Chunks written per second of writer time
+            };
+
+            AutoSaver(World* world) : _world(world), _interval(6000), _budget(2000), _cycleStart(0), _busySeconds(0),
+                                      _snapshotCount(0), _writtenCount(0), _cancelledCount(0), _failedCount(0),
+                                      _busy(false), _stop(false) {}
+
+            /** Writes the queued copies and stops the writer */
+            ~AutoSaver();
+
+            // SETTINGS
+            /** Ticks between the start of two save cycles, 0 disables autosaving */
+            void setInterval(unsigned int ticks) { _interval = ticks; }
+            unsigned int getInterval() const { return _interval; }
+
+            /** Time each tick may spend copying chunks, in microseconds */
+            void setTickBudget(unsigned int microseconds) { _budget = microseconds; }
+            unsigned int getTickBudget() const { return _budget; }
+
+            // SAVING
+            /** Runs on the tick thread, continues or starts a save cycle */
+            void update(uint64_t tick);
+
+            /** Drops the queued and written copies of a chunk, must be called before it's saved or reloaded synchronously */
+            void cancel(const Point3D& point);
+
+            /** Blocks until every queued copy is written */
+            void flush();
+
+            /** Tick thread only */
+            Stats getStats() const;
+
+        protected:
+            struct Snapshot
+            {
+                Point3D point;
+
+                uint64_t serial; // Of the original, see Chunk::getSerial
+
+                Chunk* copy;
+
+                uint32_t count;
+
+                bool cancelled;
+            };
+
+            struct Written
+            {
+                Point3D point;
+
+                uint64_t serial;
+
+                uint32_t count;
+            };
+
+            typedef std::deque<Snapshot*> SnapshotQueue;
+            typedef std::unordered_map<ChunkIndex::Key, Snapshot*> SnapshotMap;
+
+            World* _world;
+
+            unsigned int _interval;
+            unsigned int _budget;
+
+            uint64_t _cycleStart;
+
+            std::vector<Point3D> _remaining; // Tick thread only
+
+            // Shared with the writer, guarded by _mutex
+            SnapshotQueue _queue;
+            SnapshotMap   _latest; // Last queued copy of each chunk
+
+            std::vector<Written> _written;
+
+            double _busySeconds;
+
+            uint64_t _snapshotCount;
+            uint64_t _writtenCount;
+            uint64_t _cancelledCount;
+            uint64_t _failedCount;
+
+            bool _busy;
+            bool _stop;
+
+            mutable std::mutex _mutex;
+
+            std::condition_variable _wake;
+            std::condition_variable _idle;
+
+            std::thread _writer;
+
+            void write();
+
+        private:
+            AutoSaver(const AutoSaver& orig);
+            AutoSaver& operator=(const AutoSaver& orig);
+    };
+}
+
+#endif //AUTOSAVER_INCLUDED
@@ -0,0 +1,139 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef BLOCKDATA_INCLUDED
+#define BLOCKDATA_INCLUDED
+
+#include <vector>
+
+#include <cstring>
+
+#include <stdint.h>
+
+/**
+ * @file Sparse storage for per-block data
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Open addressed map from a local block index (Chunk::index) to
+     * a small typed payload. Only the few blocks that carry extra data
+     * (signs, chests, ...) take up space.
+     *
+     * Payloads are plain values of at most 8 bytes, bigger data should be
+     * kept by the owning module and referenced by an ID stored here.
+     */
+    class BlockDataTable
+    {
+        public:
+            typedef unsigned short Type;
+
+            struct Entry
+            {
+                unsigned short index;
+                Type type;
+
+                uint64_t value;
+            };
+
+            typedef std::vector<Entry> EntryList;
+
+            static const unsigned short EMPTY = 0xFFFF;
+
+            /** Iterates over the occupied entries */
+            class const_iterator
+            {
+                protected:
+                    const Entry* _it;
+                    const Entry* _end;
+
+                    void skip() { while (_it != _end && _it->index == EMPTY) ++_it; }
+
+                public:
+                    const_iterator(const Entry* it, const Entry* end) : _it(it), _end(end) { skip(); }
+
+                    const Entry& operator*() const  { return *_it; }
+                    const Entry* operator->() const { return _it; }
+
+                    const_iterator& operator++() { ++_it; skip(); return *this; }
+
+                    bool operator==(const const_iterator& it) const { return _it == it._it; }
+                    bool operator!=(const const_iterator& it) const { return _it != it._it; }
+            };
+
+            BlockDataTable() : _size(0), _modCount(0) {}
+
+            // ACCESS
+            const Entry* find(unsigned int index) const;
+
+            bool has(unsigned int index) const { return find(index); }
+
+            /** Reads a payload, fails if it is missing or of another type */
+            template <typename T>
+            bool get(unsigned int index, Type type, T& out) const
+            {
+                static_assert(sizeof(T) <= sizeof(uint64_t), "Block data payloads are limited to 8 bytes");
+
+                const Entry* entry = find(index);
+
+                if (!entry || entry->type != type) return false;
+
+                std::memcpy(&out, &entry->value, sizeof(T));
+
+                return true;
+            }
+
+            /** Stores a payload, replacing any previous one */
+            template <typename T>
+            void set(unsigned int index, Type type, const T& value)
+            {
+                static_assert(sizeof(T) <= sizeof(uint64_t), "Block data payloads are limited to 8 bytes");
+
+                uint64_t raw = 0;
+
+                std::memcpy(&raw, &value, sizeof(T));
+
+                insert(index, type, raw);
+            }
+
+            bool erase(unsigned int index);
+
+            void clear();
+
+            // INFO
+            unsigned int size() const { return _size; }
+
+            bool empty() const { return !_size; }
+
+            /** Incremented by every change */
+            uint32_t getModificationCount() const { return _modCount; }
+
+            size_t getMemoryUsage() const { return _entries.capacity() * sizeof(Entry); }
+
+            const_iterator begin() const { return const_iterator(_entries.data(), _entries.data() + _entries.size()); }
+            const_iterator end() const   { return const_iterator(_entries.data() + _entries.size(), _entries.data() + _entries.size()); }
+
+        protected:
+            EntryList _entries; // Power of two sized, empty until first insertion
+
+            unsigned int _size;
+
+            uint32_t _modCount;
+
+            inline unsigned int slot(unsigned int index) const
+            {
+                return ((index * 0x9E3779B1u) >> 16) & (_entries.size() - 1);
+            }
+
+            void insert(unsigned int index, Type type, uint64_t value);
+
+            void rehash(unsigned int capacity);
+    };
+}
+
+#endif //BLOCKDATA_INCLUDED
@@ -0,0 +1,193 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef BLOCKPROPERTIES_INCLUDED
+#define BLOCKPROPERTIES_INCLUDED
+
+#include "Chunk.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+/**
+ * @file Block properties by block ID
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Structure of arrays over the registered block types: a bitset per
+     * yes/no property and a byte per light level, indexed by block ID.
+     * Filled by State::registerBlock from the BlockInfo flags.
+     *
+     * IDs nobody registered have no property and emit no light.
+     */
+    class BlockProperties
+    {
+        public:
+            enum Property
+            {
+                SOLID,
+                OPAQUE,
+                TICKABLE,    // Takes random ticks
+                REPLACEABLE, // Placing a block overwrites it (air, water, tall grass)
+                LIGHT_SOURCE,
+
+                PROPERTY_COUNT
+            };
+
+            /** Records the properties of a block type */
+            void set(Chunk::BlockID id, bool solid, bool opaque, bool tickable, bool replaceable, unsigned char light);
+
+            inline bool has(Chunk::BlockID id, Property property) const
+            {
+                const std::vector<uint64_t>& bits = _bits[property];
+
+                return id / 64u < bits.size() && (bits[id / 64] >> (id % 64)) & 1;
+            }
+
+            inline unsigned char getLight(Chunk::BlockID id) const { return id < _light.size() ? _light[id] : 0; }
+
+            /** Number of block IDs covered */
+            unsigned int size() const { return _light.size(); }
+
+        protected:
+            std::vector<uint64_t> _bits[PROPERTY_COUNT];
+
+            std::vector<unsigned char> _light;
+    };
+
+    /**
+     * Tests one property for whole columns of a chunk at once.
+     *
+     * The property is looked up once per palette entry, columns (16
+     * blocks along y, contiguous in Chunk::index order) are then matched
+     * straight from the packed indices: a byte shuffle per column with
+     * SSSE3 for palettes of up to 16 entries, bit twiddling over the
+     * packed word otherwise, and a table lookup per block for palettes
+     * above 16 entries.
+     *
+     * The chunk must not change while the query is in use.
+     */
+    class ColumnQuery
+    {
+        public:
+            ColumnQuery(const BlockProperties& properties, const Chunk& chunk, BlockProperties::Property property);
+
+            /** Bit y is set when the block at (x, y, z) has the property */
+            inline uint16_t column(unsigned int x, unsigned int z) const
+            {
+                const unsigned int first = (x * CHUNK_LENGTH + z) * CHUNK_HEIGHT;
+
+                switch (_bits)
+                {
+                    case 0:
+                        return _uniform;
+
+                    case 1:
+                    {
+                        uint64_t word = _data[first / 64] >> (first % 64);
+
+                        return (word & _valueMask[1]) | (~word & _valueMask[0]);
+                    }
+
+                    case 2:
+                        return matchPairs(_data[first / 32] >> (first % 32 * 2));
+
+                    case 4:
+                        return matchNibbles(_data[first / 16]);
+
+                    default:
+                        return matchTable(first);
+                }
+            }
+
+        protected:
+            const uint64_t* _data;
+
+            unsigned char _bits;
+
+            uint16_t _uniform; // 0xFFFF or 0 for uniform chunks
+
+            uint16_t _valueMask[16]; // 0xFFFF for the palette entries having the property
+
+            std::vector<unsigned char> _table; // Same, one byte per palette entry
+
+#ifdef __SSSE3__
+            __m128i _shuffle; // 0x80 for the palette entries having the property
+#endif
+
+            /** 16 two bit entries in the low 32 bits */
+            inline uint16_t matchPairs(uint64_t word) const
+            {
+                uint64_t match = 0;
+
+                for (unsigned int value = 0; value < 4; ++value)
+                {
+                    if (!_valueMask[value]) continue;
+
+                    // Both bits of a pair are set where the entry equals value
+                    uint64_t equal = ~(word ^ (value * 0x55555555ull));
+
+                    match |= equal & (equal >> 1) & 0x55555555ull;
+                }
+
+                // Gather every second bit
+                match = (match | (match >> 1)) & 0x33333333ull;
+                match = (match | (match >> 2)) & 0x0F0F0F0Full;
+                match = (match | (match >> 4)) & 0x00FF00FFull;
+                match = (match | (match >> 8)) & 0x0000FFFFull;
+
+                return match;
+            }
+
+            /** 16 four bit entries filling a word */
+            inline uint16_t matchNibbles(uint64_t word) const
+            {
+#ifdef __SSSE3__
+                const __m128i low = _mm_set1_epi8(0x0F);
+
+                __m128i packed = _mm_cvtsi64_si128(word);
+
+                // One entry per byte, in order
+                __m128i entries = _mm_unpacklo_epi8(_mm_and_si128(packed, low), _mm_and_si128(_mm_srli_epi16(packed, 4), low));
+
+                return _mm_movemask_epi8(_mm_shuffle_epi8(_shuffle, entries));
+#else
+                uint64_t match = 0;
+
+                for (unsigned int value = 0; value < 16; ++value)
+                {
+                    if (!_valueMask[value]) continue;
+
+                    uint64_t diff = word ^ (value * 0x1111111111111111ull);
+
+                    // High bit of a nibble is set where diff is zero there
+                    match |= ~(((diff & 0x7777777777777777ull) + 0x7777777777777777ull) | diff) & 0x8888888888888888ull;
+                }
+
+                // Gather every fourth bit
+                match >>= 3;
+                match = (match | (match >> 3)) & 0x0303030303030303ull;
+                match = (match | (match >> 6)) & 0x000F000F000F000Full;
+                match = (match | (match >> 12)) & 0x000000FF000000FFull;
+                match = (match | (match >> 24)) & 0x000000000000FFFFull;
+
+                return match;
+#endif
+            }
+
+            uint16_t matchTable(unsigned int first) const;
+    };
+}
+
+#endif //BLOCKPROPERTIES_INCLUDED
@@ -0,0 +1,125 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef BLOCKUPDATESCHEDULER_INCLUDED
+#define BLOCKUPDATESCHEDULER_INCLUDED
+
+#include "ChunkIndex.hpp"
+#include "Point3D.hpp"
+#include "ThreadPool.hpp"
+
+// STL
+#include <vector>
+
+// C++11
+#include <functional>
+
+/**
+ * @file Parallel block updates
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Runs a tick's block updates across the worker pool.
+     *
+     * Updates are grouped by chunk, chunks by cubic regions of
+     * regionSize chunks. Regions are coloured like a 3D checkerboard
+     * (8 colours) and the colours run one after the other; the regions of
+     * one colour run concurrently. Two regions of the same colour are
+     * always regionSize chunks apart, so updates touching no more than
+     * getReach() chunks away from their own never meet. That includes
+     * scheduling further updates (World::scheduleUpdate).
+     *
+     * The order is fixed by the positions alone: colour, region, chunk,
+     * then submission order. Running serially uses the same order, so the
+     * results don't depend on the number of threads.
+     */
+    class BlockUpdateScheduler
+    {
+        public:
+            typedef std::vector<Point3D> BlockList;
+
+            typedef std::function<void(const Point3D& block)> UpdateFunction;
+
+            static const unsigned int COLOURS = 8;
+
+            struct Stats
+            {
+                unsigned int updates;
+                unsigned int chunks;
+                unsigned int regions;
+
+                bool parallel;
+
+                Stats() : updates(0), chunks(0), regions(0), parallel(false) {}
+            };
+
+            BlockUpdateScheduler() : _regionSize(2), _threshold(256), _parallel(false) {}
+
+            // SETTINGS
+            /** Region edge in chunks (at least 2) */
+            void setRegionSize(unsigned int chunks) { _regionSize = chunks < 2 ? 2 : chunks; }
+            unsigned int getRegionSize() const { return _regionSize; }
+
+            /** How many chunks away from its own an update may read or write */
+            unsigned int getReach() const { return _regionSize / 2; }
+
+            /** Spreads the regions over the worker pool */
+            void setParallel(bool enable) { _parallel = enable; }
+            bool getParallel() const { return _parallel; }
+
+            /** Passes with fewer updates run serially */
+            void setParallelThreshold(unsigned int updates) { _threshold = updates; }
+            unsigned int getParallelThreshold() const { return _threshold; }
+
+            // SCHEDULING
+            /** Sorts a pass' updates (world block positions) into regions */
+            void partition(const BlockList& blocks);
+
+            /** Lists every chunk the partitioned updates may reach */
+            void getReachedChunks(std::vector<Point3D>& chunks) const;
+
+            /** Whether run() spreads the partitioned updates over the worker pool */
+            bool isParallelPass() const { return _parallel && _blocks.size() >= _threshold && _regions.size() > 1; }
+
+            /**
+             * Runs the partitioned updates, colour after colour, and
+             * forgets them. Update functions must stay within getReach().
+             */
+            void run(ThreadPool& pool, const UpdateFunction& update);
+
+            /** Statistics of the last pass */
+            const Stats& getStats() const { return _stats; }
+
+        protected:
+            struct Range
+            {
+                unsigned int begin;
+                unsigned int end;
+            };
+
+            BlockList _blocks; // Sorted in update order
+
+            std::vector<ChunkIndex::Key> _chunks; // Chunks with updates, sorted
+
+            std::vector<Range> _regions; // Sorted by colour
+
+            unsigned int _colours[COLOURS + 1]; // First region of each colour
+
+            unsigned int _regionSize;
+            unsigned int _threshold;
+
+            bool _parallel;
+
+            Stats _stats;
+
+            void runRegion(unsigned int region, const UpdateFunction& update) const;
+    };
+}
+
+#endif //BLOCKUPDATESCHEDULER_INCLUDED
@@ -7,13 +7,19 @@
 #ifndef CHUNK_INCLUDED
 #define CHUNK_INCLUDED
 
-#include "Metadata.hpp"
+#include "BlockData.hpp"
+#include "ChunkPool.hpp"
+#include "Point3D.hpp"
+#include "ScheduledUpdates.hpp"
 
 #include <map>
+#include <vector>
 
 #include <cstring>
 #include <string>
 
+#include <stdint.h>
+
 /**
  * @file Interface for chunks
  *
@@ -23,20 +29,184 @@
 #define CHUNK_LENGTH 16
 #define CHUNK_HEIGHT 16
 
+#define CHUNK_VOLUME (CHUNK_WIDTH * CHUNK_LENGTH * CHUNK_HEIGHT)
+
 namespace EJV
 {
-    struct Block : public Metadata
+    struct Block
     {
         unsigned short ID;
     };
 
-	struct Chunk
+	/**
+	 * Palette compressed block storage.
+	 *
+	 * Blocks are stored as indices into a palette of block IDs,
+	 * bit-packed into 64-bit words (1, 2, 4, 8 or 16 bits per block).
+	 * A chunk made of a single block type stores no indices at all.
+	 *
+	 * Extra per-block data lives in a sparse BlockDataTable and pending
+	 * block updates in a ScheduledUpdates list, both keyed by the same
+	 * local index. Like the blocks, they are only writable through
+	 * private chunks (editBlockData, editScheduledUpdates).
+	 *
+	 * Chunks and their indices are allocated from the core's ChunkPool.
+	 *
+	 * Uniform chunks may be the shared, immutable instance of their
+	 * block type (getShared). Those must never be written to or deleted,
+	 * World::editChunk replaces them by a private copy first.
+	 */
+	class Chunk
 	{
-		/**
-		 * Short array indexed by [width][length][height] (xzy)
-		 * representing blockdata.
-		 */
-        Block blocks[CHUNK_WIDTH][CHUNK_LENGTH][CHUNK_HEIGHT];
+		public:
+            typedef unsigned short BlockID;
+            typedef std::vector<BlockID> Palette;
+            typedef std::vector<uint64_t, ChunkAllocator<uint64_t> > IndexList;
+
+            /** Creates a chunk filled with a single block type */
+            Chunk(BlockID fill = 0) : _uniform(fill), _bits(0), _shared(false), _modCount(1), _savedCount(0), _serial(nextSerial()) {}
+
+            /** Copies are always private, even when copying a shared chunk */
+            Chunk(const Chunk& orig) : _blockData(orig._blockData), _scheduledUpdates(orig._scheduledUpdates), _palette(orig._palette), _data(orig._data),
+                                       _uniform(orig._uniform), _bits(orig._bits), _shared(false),
+                                       _modCount(orig._modCount), _savedCount(orig._savedCount), _serial(nextSerial()) {}
+
+            Chunk& operator=(const Chunk& orig);
+
+            // SHARING
+            /** The shared immutable chunk made only of one block type */
+            static Chunk* getShared(BlockID id);
+
+            bool isShared() const { return _shared; }
+
+            /** Deletes a chunk unless it is a shared one */
+            static void release(Chunk* chunk) { if (chunk && !chunk->_shared) delete chunk; }
+
+            // ALLOCATION
+            static void* operator new(size_t size) { return ChunkPool::GET().allocate(size); }
+
+            static void operator delete(void* chunk, size_t size) { ChunkPool::GET().free(chunk, size); }
+
+            /** Local index of a block, ordered [width][length][height] (xzy) */
+            static inline unsigned int index(unsigned int x, unsigned int y, unsigned int z)
+            {
+                return (x * CHUNK_LENGTH + z) * CHUNK_HEIGHT + y;
+            }
+
+            /** Inverse of index() */
+            static inline Point3D position(unsigned int i)
+            {
+                return Point3D(i / (CHUNK_LENGTH * CHUNK_HEIGHT), i % CHUNK_HEIGHT, i / CHUNK_HEIGHT % CHUNK_LENGTH);
+            }
+
+            // BLOCK ACCESS
+            inline BlockID getBlock(unsigned int x, unsigned int y, unsigned int z) const
+            {
+                return getBlockAt(index(x, y, z));
+            }
+
+            inline BlockID getBlockAt(unsigned int i) const
+            {
+                if (!_bits) return _uniform;
+
+                const unsigned int perWord = 64 / _bits;
+
+                uint64_t entry = _data[i / perWord] >> ((i % perWord) * _bits);
+
+                return _palette[entry & ((uint64_t(1) << _bits) - 1)];
+            }
+
+            inline void setBlock(unsigned int x, unsigned int y, unsigned int z, BlockID id)
+            {
+                setBlockAt(index(x, y, z), id);
+            }
+
+            void setBlockAt(unsigned int i, BlockID id);
+
+            /** Replaces every block of the chunk */
+            void fill(BlockID id);
+
+            /** Drops unused palette entries and shrinks the indices (may make the chunk uniform) */
+            void compact();
+
+            // BLOCK DATA
+            /** Extra data of individual blocks, keyed by index() */
+            const BlockDataTable& getBlockData() const { return _blockData; }
+
+            /** Throws on shared chunks */
+            BlockDataTable& editBlockData() { checkWritable(); return _blockData; }
+
+            // SCHEDULED UPDATES
+            /** Block updates waiting for their tick, keyed by index() */
+            const ScheduledUpdates& getScheduledUpdates() const { return _scheduledUpdates; }
+
+            /** Throws on shared chunks */
+            ScheduledUpdates& editScheduledUpdates() { checkWritable(); return _scheduledUpdates; }
+
+            // CHANGES
+            /** Incremented by every change to the blocks, their data or scheduled updates */
+            uint32_t getModificationCount() const
+            {
+                return _modCount + _blockData.getModificationCount() + _scheduledUpdates.getModificationCount();
+            }
+
+            /** New chunks are dirty until saved, shared chunks never are */
+            bool isDirty() const { return !_shared && getModificationCount() != _savedCount; }
+
+            /** Unique to this chunk object, unlike its address the pool never hands it out again */
+            uint64_t getSerial() const { return _serial; }
+
+            /** Marks the state with the given modification count as saved */
+            void markSaved(uint32_t count) { _savedCount = count; }
+
+            void markSaved() { _savedCount = getModificationCount(); }
+
+            // STORAGE INFO
+            bool isUniform() const { return !_bits; }
+
+            unsigned int getBitsPerBlock() const { return _bits; }
+
+            unsigned int getPaletteSize() const { return _bits ? _palette.size() : 1; }
+
+            BlockID getPaletteEntry(unsigned int i) const { return _bits ? _palette[i] : _uniform; }
+
+            /** Packed palette indices in index() order, 64 / getBitsPerBlock() per word (none if uniform) */
+            const uint64_t* getIndexWords() const { return _data.data(); }
+
+            /** Approximate heap + object size in bytes, shared chunks cost nothing */
+            size_t getMemoryUsage() const
+            {
+                if (_shared) return 0;
+
+                return sizeof(Chunk) + _palette.capacity() * sizeof(BlockID) + _data.capacity() * sizeof(uint64_t)
+                     + _blockData.getMemoryUsage() + _scheduledUpdates.getMemoryUsage();
+            }
+
+        protected:
+            BlockDataTable   _blockData;
+            ScheduledUpdates _scheduledUpdates;
+
+            Palette   _palette;
+            IndexList _data;
+
+            BlockID _uniform; // Only valid while _bits == 0
+
+            unsigned char _bits;
+
+            bool _shared;
+
+            uint32_t _modCount;
+            uint32_t _savedCount;
+
+            uint64_t _serial;
+
+            static uint64_t nextSerial();
+
+            /** Throws when writing to a shared chunk */
+            void checkWritable() const;
+
+            /** Repacks the indices using a new entry width */
+            void repack(unsigned char bits);
 	};
 }
 
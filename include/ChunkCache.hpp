@@ -0,0 +1,109 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKCACHE_INCLUDED
+#define CHUNKCACHE_INCLUDED
+
+#include "ChunkIndex.hpp"
+#include "ChunkTickets.hpp"
+#include "Point3D.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+// C++11
+#include <atomic>
+
+/**
+ * @file Memory budget of the loaded chunks
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Residency policy of a world's chunks.
+     *
+     * The world stamps every chunk access with the current tick. Every
+     * few ticks the cache measures the loaded chunks and, when they exceed
+     * the budget, picks the least recently used ones for unloading until
+     * usage drops below the low watermark.
+     */
+    class ChunkCache
+    {
+        public:
+            struct Stats
+            {
+                uint64_t hits;
+                uint64_t misses;
+                uint64_t evictions;
+
+                size_t residentBytes;  // As of the last eviction pass
+                unsigned int residentChunks;
+
+                Stats() : hits(0), misses(0), evictions(0), residentBytes(0), residentChunks(0) {}
+            };
+
+            ChunkCache() : _budget(0), _lowWatermark(90), _interval(20), _hits(0), _misses(0) {}
+
+            // SETTINGS
+            /** Maximum memory used by loaded chunks in bytes, 0 disables eviction */
+            void setMemoryBudget(size_t bytes) { _budget = bytes; }
+            size_t getMemoryBudget() const { return _budget; }
+
+            /** Percentage of the budget eviction brings usage down to */
+            void setLowWatermark(unsigned int percent) { _lowWatermark = percent > 100 ? 100 : percent; }
+            unsigned int getLowWatermark() const { return _lowWatermark; }
+
+            /** Number of ticks between two eviction passes */
+            void setEvictionInterval(unsigned int ticks) { _interval = ticks ? ticks : 1; }
+            unsigned int getEvictionInterval() const { return _interval; }
+
+            // STATISTICS
+            Stats getStats() const
+            {
+                Stats stats = _stats;
+
+                stats.hits = _hits.load(std::memory_order_relaxed);
+                stats.misses = _misses.load(std::memory_order_relaxed);
+
+                return stats;
+            }
+
+            void resetStats() { _stats = Stats(); _hits = 0; _misses = 0; }
+
+            /** Safe from block updates running on the workers */
+            void recordHit()  { _hits.fetch_add(1, std::memory_order_relaxed); }
+            void recordMiss() { _misses.fetch_add(1, std::memory_order_relaxed); }
+
+            void recordEviction() { ++_stats.evictions; }
+
+            // EVICTION
+            bool isPassDue(uint64_t tick) const { return tick % _interval == 0; }
+
+            /**
+             * Measures the loaded chunks and lists the ones to unload,
+             * least recently used first. Ticketed chunks, chunks used
+             * during the current tick and chunks with scheduled block
+             * updates are never picked.
+             */
+            void selectVictims(const ChunkIndex& chunks, const ChunkTickets& tickets, uint32_t tick, std::vector<Point3D>& victims);
+
+        protected:
+            size_t _budget;
+
+            unsigned int _lowWatermark;
+            unsigned int _interval;
+
+            Stats _stats;
+
+            std::atomic<uint64_t> _hits;
+            std::atomic<uint64_t> _misses;
+    };
+}
+
+#endif //CHUNKCACHE_INCLUDED
@@ -0,0 +1,155 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKINDEX_INCLUDED
+#define CHUNKINDEX_INCLUDED
+
+#include "Chunk.hpp"
+#include "Point3D.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * @file Hash index of loaded chunks
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Open addressed hash table from chunk coordinates to chunks.
+     *
+     * Coordinates are packed into a single 64-bit key (21 bits per axis),
+     * probing is linear and erasing uses backward shifting, so lookups
+     * never chase pointers until the chunk itself is reached.
+     *
+     * Stored Chunk pointers are the handles; they stay valid until the
+     * chunk is erased, no matter how often the table grows.
+     */
+    class ChunkIndex
+    {
+        public:
+            typedef uint64_t Key;
+
+            struct Entry
+            {
+                Key key;
+
+                Chunk* chunk;
+
+                uint32_t lastUsed; // Tick of the last access, kept by the owner
+
+                Point3D getPoint() const { return ChunkIndex::point(key); }
+            };
+
+            typedef std::vector<Entry> EntryList;
+
+            static const Key EMPTY = ~Key(0); // Never produced by key(), bit 63 is unused
+
+            // Coordinates keys tell apart, 21 bits each
+            static const int MIN_COORDINATE = -(1 << 20);
+            static const int MAX_COORDINATE = (1 << 20) - 1;
+
+            /** Iterates over the occupied entries */
+            class const_iterator
+            {
+                protected:
+                    const Entry* _it;
+                    const Entry* _end;
+
+                    void skip() { while (_it != _end && _it->key == EMPTY) ++_it; }
+
+                public:
+                    const_iterator(const Entry* it, const Entry* end) : _it(it), _end(end) { skip(); }
+
+                    const Entry& operator*() const  { return *_it; }
+                    const Entry* operator->() const { return _it; }
+
+                    const_iterator& operator++() { ++_it; skip(); return *this; }
+
+                    bool operator==(const const_iterator& it) const { return _it == it._it; }
+                    bool operator!=(const const_iterator& it) const { return _it != it._it; }
+            };
+
+            ChunkIndex() : _size(0) {}
+
+            // KEYS
+            static inline Key key(const Point3D& point)
+            {
+                return (Key(point.x & 0x1FFFFF) << 42) | (Key(point.y & 0x1FFFFF) << 21) | Key(point.z & 0x1FFFFF);
+            }
+
+            static inline Point3D point(Key key)
+            {
+                // Shift the 21-bit fields up to bit 63 and back to sign extend them
+                return Point3D(int64_t(key << 1) >> 43, int64_t(key << 22) >> 43, int64_t(key << 43) >> 43);
+            }
+
+            /** Converts a floored coordinate to the key range without overflowing, NaN ends up at MIN_COORDINATE */
+            static inline int clampCoordinate(double c)
+            {
+                if (!(c >= MIN_COORDINATE)) return MIN_COORDINATE;
+
+                return c <= MAX_COORDINATE ? int(c) : MAX_COORDINATE;
+            }
+
+            // ACCESS
+            inline Chunk* find(const Point3D& point) const { return find(key(point)); }
+
+            inline Chunk* find(Key key) const
+            {
+                const Entry* entry = findEntry(key);
+
+                return entry ? entry->chunk : 0;
+            }
+
+            inline Entry* lookup(const Point3D& point) { return const_cast<Entry*>(findEntry(key(point))); }
+
+            const Entry* findEntry(Key key) const;
+
+            /** Inserts or replaces a chunk, returns the replaced one (or NULL) */
+            Chunk* insert(const Point3D& point, Chunk* chunk);
+
+            /** Removes a chunk from the index and returns it (or NULL) */
+            Chunk* erase(const Point3D& point);
+
+            void clear();
+
+            /** Makes room for count chunks without rehashing */
+            void reserve(unsigned int count);
+
+            // INFO
+            unsigned int size() const { return _size; }
+
+            bool empty() const { return !_size; }
+
+            const_iterator begin() const { return const_iterator(_entries.data(), _entries.data() + _entries.size()); }
+            const_iterator end() const   { return const_iterator(_entries.data() + _entries.size(), _entries.data() + _entries.size()); }
+
+        protected:
+            EntryList _entries; // Power of two sized
+
+            unsigned int _size;
+
+            inline unsigned int slot(Key key) const
+            {
+                // 64-bit finalizer from MurmurHash3
+                key ^= key >> 33;
+                key *= 0xFF51AFD7ED558CCDull;
+                key ^= key >> 33;
+                key *= 0xC4CEB9FE1A85EC53ull;
+                key ^= key >> 33;
+
+                return key & (_entries.size() - 1);
+            }
+
+            void rehash(unsigned int capacity);
+    };
+}
+
+#endif //CHUNKINDEX_INCLUDED
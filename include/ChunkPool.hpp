@@ -0,0 +1,151 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKPOOL_INCLUDED
+#define CHUNKPOOL_INCLUDED
+
+// STL
+#include <new>
+#include <vector>
+
+// C++11
+#include <mutex>
+
+#include <cstddef>
+
+/**
+ * @file Pooled memory for chunks
+ *
+ */
+
+namespace EJV
+{
+    /** Fixed size blocks carved out of large slabs, recycled through a free list */
+    class SlabPool
+    {
+        public:
+            struct Stats
+            {
+                size_t live;      // Blocks in use
+                size_t peak;      // Most blocks ever in use at once
+                size_t freeCount; // Length of the free list
+                size_t slabs;
+            };
+
+            SlabPool(size_t blockSize);
+
+            /** Returns the slabs to the system, every block must be freed by then */
+            ~SlabPool();
+
+            void* allocate();
+
+            void free(void* block);
+
+            /** Backs slabs allocated from now on with transparent huge pages */
+            void setHugePages(bool enable);
+
+            size_t getBlockSize() const { return _blockSize; }
+
+            Stats getStats() const;
+
+        protected:
+            struct FreeBlock
+            {
+                FreeBlock* next;
+            };
+
+            struct Slab
+            {
+                void* memory;
+
+                size_t size;
+
+                bool mapped;
+            };
+
+            size_t _blockSize;
+
+            FreeBlock* _free;
+
+            std::vector<Slab> _slabs;
+
+            Stats _stats;
+
+            bool _hugePages;
+
+            mutable std::mutex _mutex;
+
+            void grow();
+
+        private:
+            SlabPool(const SlabPool& orig);
+            SlabPool& operator=(const SlabPool& orig);
+    };
+
+    /**
+     * Core owned pools for Chunk objects and their packed indices.
+     * Chunks allocated with new in any module end up here, so they
+     * can be deleted by the core (and vice versa).
+     */
+    class ChunkPool
+    {
+        private:
+            // Singleton
+            static ChunkPool *_singleton;
+
+            ChunkPool();
+            ChunkPool(const ChunkPool& orig);
+            ChunkPool& operator=(const ChunkPool& orig);
+
+        protected:
+            // Chunk objects, then indices at 1, 2, 4, 8 and 16 bits per block
+            static const unsigned int POOL_COUNT = 6;
+
+            SlabPool* _pools[POOL_COUNT];
+
+            SlabPool* findPool(size_t size) const;
+
+        public:
+            // MUST NOT BE INLINED
+            static ChunkPool &GET();
+
+            /** Memory from the matching pool, or from the heap for other sizes */
+            void* allocate(size_t size);
+
+            void free(void* memory, size_t size);
+
+            void setHugePages(bool enable);
+
+            /** Statistics of the pool serving a size, NULL if there's none */
+            const SlabPool* getPool(size_t size) const { return findPool(size); }
+
+            SlabPool::Stats getChunkStats() const { return _pools[0]->getStats(); }
+    };
+
+    /** Standard allocator drawing from the ChunkPool */
+    template <typename T>
+    struct ChunkAllocator
+    {
+        typedef T value_type;
+
+        ChunkAllocator() {}
+
+        template <typename U>
+        ChunkAllocator(const ChunkAllocator<U>&) {}
+
+        T* allocate(size_t n) { return (T*) ChunkPool::GET().allocate(n * sizeof(T)); }
+
+        void deallocate(T* p, size_t n) { ChunkPool::GET().free(p, n * sizeof(T)); }
+
+        template <typename U>
+        bool operator==(const ChunkAllocator<U>&) const { return true; }
+
+        template <typename U>
+        bool operator!=(const ChunkAllocator<U>&) const { return false; }
+    };
+}
+
+#endif //CHUNKPOOL_INCLUDED
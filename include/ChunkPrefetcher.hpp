@@ -0,0 +1,87 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKPREFETCHER_INCLUDED
+#define CHUNKPREFETCHER_INCLUDED
+
+#include "ChunkIndex.hpp"
+#include "ChunkRequests.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Anticipated chunk loading
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Picks the chunks around moving viewers (entities) that should be
+     * loaded before anything touches them.
+     *
+     * Candidates are the chunks within the view radius of a viewer, ranked
+     * by their distance to either the viewer or the position it will reach
+     * after the lookahead, so chunks in the direction of travel come first.
+     */
+    class ChunkPrefetcher
+    {
+        public:
+            ChunkPrefetcher() : _radius(4), _verticalRadius(2), _lookahead(40), _interval(4), _maxRequests(64) {}
+
+            // SETTINGS
+            /** Radius in chunks, horizontally and vertically */
+            void setViewRadius(unsigned int radius, unsigned int verticalRadius) { _radius = radius; _verticalRadius = verticalRadius; }
+            unsigned int getViewRadius() const { return _radius; }
+            unsigned int getVerticalViewRadius() const { return _verticalRadius; }
+
+            /** Number of ticks a viewer's velocity is extrapolated over */
+            void setLookahead(unsigned int ticks) { _lookahead = ticks; }
+            unsigned int getLookahead() const { return _lookahead; }
+
+            /** Number of ticks between two prefetch passes */
+            void setInterval(unsigned int ticks) { _interval = ticks ? ticks : 1; }
+            unsigned int getInterval() const { return _interval; }
+
+            /** Maximum number of chunks requested per pass */
+            void setMaxRequests(unsigned int count) { _maxRequests = count; }
+            unsigned int getMaxRequests() const { return _maxRequests; }
+
+            // PREFETCHING
+            bool isPassDue(uint64_t tick) const { return tick % _interval == 0; }
+
+            /** Adds a viewer at a block position moving at a velocity in blocks per tick */
+            void addViewer(double x, double y, double z, double velX, double velY, double velZ);
+
+            /**
+             * Lists the missing chunks around the viewers, most urgent first,
+             * and forgets the viewers.
+             */
+            void select(const ChunkIndex& loaded, const ChunkRequests& pending, std::vector<Point3D>& chunks);
+
+        protected:
+            struct Viewer
+            {
+                double x, y, z;
+                double velX, velY, velZ;
+            };
+
+            typedef std::unordered_map<ChunkIndex::Key, Viewer> ViewerMap;
+
+            ViewerMap _viewers; // One per chunk, the fastest wins
+
+            unsigned int _radius;
+            unsigned int _verticalRadius;
+            unsigned int _lookahead;
+            unsigned int _interval;
+            unsigned int _maxRequests;
+    };
+}
+
+#endif //CHUNKPREFETCHER_INCLUDED
@@ -0,0 +1,89 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKREQUESTS_INCLUDED
+#define CHUNKREQUESTS_INCLUDED
+
+#include "Chunk.hpp"
+#include "ChunkIndex.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+// C++11
+#include <mutex>
+
+/**
+ * @file Bookkeeping of asynchronous chunk loads
+ *
+ */
+
+namespace EJV
+{
+    struct World;
+
+    /**
+     * Called on the tick thread once a requested chunk is installed.
+     * The chunk is NULL if it could neither be loaded nor generated.
+     */
+    typedef void (*ChunkCallback)(World* world, const Point3D& point, Chunk* chunk, void* data);
+
+    /**
+     * Chunks being loaded or generated by worker threads.
+     *
+     * Requests and their callbacks are only touched by the tick thread,
+     * workers merely hand finished chunks over through complete().
+     */
+    class ChunkRequests
+    {
+        public:
+            struct Waiter
+            {
+                ChunkCallback callback;
+
+                void* data;
+            };
+
+            struct Completed
+            {
+                Point3D point;
+
+                Chunk* chunk;
+            };
+
+            typedef std::vector<Waiter> WaiterList;
+            typedef std::vector<Completed> CompletedList;
+
+            /** Adds a waiter, returns true if the chunk wasn't requested yet */
+            bool add(const Point3D& point, ChunkCallback callback, void* data);
+
+            /** Worker side: hands over a finished chunk (may be NULL) */
+            void complete(const Point3D& point, Chunk* chunk);
+
+            /** Takes every chunk finished so far */
+            void drain(CompletedList& completed);
+
+            /** Ends a request, moving its waiters to the given list */
+            void finish(const Point3D& point, WaiterList& waiters);
+
+            bool isPending(const Point3D& point) const { return _pending.count(ChunkIndex::key(point)); }
+
+            unsigned int getPendingCount() const { return _pending.size(); }
+
+        protected:
+            typedef std::unordered_map<ChunkIndex::Key, WaiterList> PendingMap;
+
+            PendingMap _pending;
+
+            CompletedList _completed; // Guarded by _mutex
+
+            std::mutex _mutex;
+    };
+}
+
+#endif //CHUNKREQUESTS_INCLUDED
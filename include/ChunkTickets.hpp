@@ -0,0 +1,117 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef CHUNKTICKETS_INCLUDED
+#define CHUNKTICKETS_INCLUDED
+
+#include "ChunkIndex.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * @file Reference counted chunk residency
+ *
+ */
+
+namespace EJV
+{
+    enum TicketType
+    {
+        TICKET_PLAYER,       // Spawned entities of types with a ticketRadius, see EntityInfo
+        TICKET_ENTITY,
+        TICKET_BLOCK_UPDATE, // Chunks with scheduled updates
+        TICKET_PLUGIN,
+
+        TICKET_COUNT
+    };
+
+    /** What a ticket keeps going in its chunks, each level includes the previous ones */
+    enum TicketLevel
+    {
+        TICKET_LEVEL_LOADED,
+        TICKET_LEVEL_TICKING,
+        TICKET_LEVEL_ENTITY_TICKING,
+
+        TICKET_LEVEL_COUNT
+    };
+
+    /**
+     * Tickets keep a cube of chunks around their center resident.
+     * Every chunk counts the tickets covering it per level; once the
+     * last one goes away the chunk is reported as released.
+     */
+    class ChunkTickets
+    {
+        public:
+            typedef unsigned int ID;
+
+            typedef std::vector<Point3D> PointList;
+
+            struct Ticket
+            {
+                TicketType type;
+                TicketLevel level;
+
+                Point3D center;
+
+                unsigned int radius;
+
+                uint64_t expiry; // Tick the ticket expires at, 0 if it never does
+            };
+
+            ChunkTickets() : _nextID(1) {}
+
+            /** Adds a ticket, newly covered chunks are appended to covered */
+            ID acquire(TicketType type, TicketLevel level, const Point3D& center, unsigned int radius, uint64_t expiry, PointList& covered);
+
+            /** Removes a ticket, chunks no longer covered are appended to released */
+            bool release(ID id, PointList& released);
+
+            /** Recenters a ticket, chunks in both areas stay covered throughout */
+            bool move(ID id, const Point3D& center, PointList& covered, PointList& released);
+
+            /** Removes the tickets expiring at or before tick */
+            void expire(uint64_t tick, PointList& released);
+
+            // INFO
+            const Ticket* getTicket(ID id) const;
+
+            bool isTicketed(const Point3D& point) const { return _chunks.count(ChunkIndex::key(point)); }
+
+            /** Highest level of the tickets covering a chunk, -1 if there are none */
+            int getLevel(const Point3D& point) const;
+
+            unsigned int getTicketCount() const { return _tickets.size(); }
+
+            unsigned int getChunkCount() const { return _chunks.size(); }
+
+        protected:
+            struct Counts
+            {
+                unsigned int levels[TICKET_LEVEL_COUNT];
+
+                unsigned int total;
+            };
+
+            typedef std::unordered_map<ID, Ticket> TicketMap;
+            typedef std::unordered_map<ChunkIndex::Key, Counts> CountMap;
+
+            TicketMap _tickets;
+            CountMap  _chunks;
+
+            ID _nextID;
+
+            void cover(const Ticket& ticket, PointList& covered);
+            void uncover(const Ticket& ticket, PointList& released);
+    };
+}
+
+#endif //CHUNKTICKETS_INCLUDED
@@ -0,0 +1,42 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef ENTITY_INCLUDED
+#define ENTITY_INCLUDED
+
+#include <stdint.h>
+
+/**
+ * @file Entities in a world
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Names an entity of a world's EntityStore.
+     *
+     * The slot is reused once the entity is destroyed, the generation
+     * tells the old handles apart: they stop resolving instead of
+     * pointing at whatever took the slot. Default constructed handles
+     * are null.
+     */
+    struct EntityHandle
+    {
+        uint32_t slot;
+        uint32_t generation; // Never 0 for live entities
+
+        EntityHandle() : slot(0), generation(0) {}
+        EntityHandle(uint32_t _slot, uint32_t _generation) : slot(_slot), generation(_generation) {}
+
+        bool isNull() const { return !generation; }
+
+        bool operator==(const EntityHandle& handle) const { return slot == handle.slot && generation == handle.generation; }
+        bool operator!=(const EntityHandle& handle) const { return !(*this == handle); }
+    };
+}
+
+#endif //ENTITY_INCLUDED
@@ -0,0 +1,121 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef ENTITYINDEX_INCLUDED
+#define ENTITYINDEX_INCLUDED
+
+#include "ChunkIndex.hpp"
+#include "Entity.hpp"
+#include "EntityStore.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * @file Entities of a world by position
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * The entities of an EntityStore, bucketed in a uniform grid of cubic
+     * cells.
+     *
+     * Every entity is in the cell holding its position. Proximity queries
+     * only look at the cells overlapping the searched volume, so they cost
+     * the number of entities nearby instead of the number in the world.
+     * Whoever moves entities calls move() or moveAll() afterwards, an
+     * entity only touches the grid when it crossed into another cell.
+     *
+     * Cells list the store's slots, which don't change when other
+     * entities are destroyed.
+     */
+    class EntityIndex
+    {
+        public:
+            typedef std::vector<EntityHandle> HandleList;
+
+            /** Cell size in blocks, chunk sized by default */
+            EntityIndex(const EntityStore& store, double cellSize = 16);
+
+            // SETTINGS
+            /** Re-buckets every entity */
+            void setCellSize(double blocks);
+            double getCellSize() const { return _cellSize; }
+
+            // ENTITIES
+            /** Call after creating an entity in the store */
+            void add(EntityHandle entity);
+
+            /** Call before destroying an entity in the store */
+            void remove(EntityHandle entity);
+
+            /** Call after changing an entity's position */
+            void move(EntityHandle entity);
+
+            /** Checks every entity of the store, after moving many */
+            void moveAll();
+
+            void clear();
+
+            // QUERIES
+            /** Appends the entities within radius blocks of a position */
+            void findInRadius(double x, double y, double z, double radius, HandleList& found) const;
+
+            /** Appends the entities inside a box (bounds included) */
+            void findInBox(double minX, double minY, double minZ, double maxX, double maxY, double maxZ, HandleList& found) const;
+
+            /** Closest entity within maxRadius blocks other than exclude, a null handle if there is none */
+            EntityHandle findNearest(double x, double y, double z, double maxRadius, EntityHandle exclude = EntityHandle()) const;
+
+            unsigned int getCellCount() const { return _cells.size(); }
+
+        protected:
+            typedef std::vector<uint32_t> SlotList;
+            typedef std::unordered_map<ChunkIndex::Key, SlotList> CellMap;
+
+            struct Box
+            {
+                double minX, minY, minZ;
+                double maxX, maxY, maxZ;
+            };
+
+            struct Location
+            {
+                Point3D cell;
+
+                uint32_t cellSlot; // Position in the cell's list
+            };
+
+            const EntityStore& _store;
+
+            CellMap _cells; // Empty cells are dropped
+
+            std::vector<Location> _locations; // By store slot
+
+            double _cellSize;
+            double _inverseCellSize;
+
+            /** Clamped to the cells ChunkIndex keys tell apart, positions out there share the border cells */
+            Point3D cellOf(double x, double y, double z) const;
+
+            /** Cell of the entity in a store slot, from its position */
+            Point3D cellOfSlot(uint32_t slot) const;
+
+            void insertIntoCell(uint32_t slot, const Point3D& cell);
+            void removeFromCell(uint32_t slot);
+
+            /** Appends the entities of a cell inside the box, all of them if the cell is inside */
+            void collect(const SlotList& slots, const Box& box, bool inner, HandleList& found) const;
+    };
+}
+
+#endif //ENTITYINDEX_INCLUDED
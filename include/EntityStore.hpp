@@ -0,0 +1,145 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef ENTITYSTORE_INCLUDED
+#define ENTITYSTORE_INCLUDED
+
+#include "Entity.hpp"
+#include "Metadata.hpp"
+
+// STL
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * @file Entity state as columns
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * The entities of a world, stored as one array per field.
+     *
+     * Live entities occupy the dense indices 0 to size() - 1 of every
+     * column, so passes over a field stream through contiguous memory.
+     * Destroying an entity moves the last one into its place: dense
+     * indices change, handles don't. Resolve a handle with find() and
+     * use the index until the next destroy().
+     *
+     * Motion is integrated for all entities at once, branch free and in
+     * SIMD where available: every entity has its own gravity and drag.
+     */
+    class EntityStore
+    {
+        public:
+            static const unsigned int NONE = ~0u;
+
+            EntityStore() : _freeSlot(NONE) {}
+
+            /** Deletes the entities' metadata */
+            ~EntityStore();
+
+            // ENTITIES
+            /** Adds an entity at rest, drag multiplies the velocity every tick (1 keeps it) */
+            EntityHandle create(unsigned short type, double x, double y, double z, double gravity = 0, double drag = 1);
+
+            /** Removes an entity, stale handles are ignored */
+            void destroy(EntityHandle entity);
+
+            void clear();
+
+            /** Dense index of a live entity, NONE for stale or null handles */
+            unsigned int find(EntityHandle entity) const
+            {
+                if (entity.slot >= _slots.size() || _slots[entity.slot].generation != entity.generation || entity.isNull()) return NONE;
+
+                return _slots[entity.slot].index;
+            }
+
+            bool isAlive(EntityHandle entity) const { return find(entity) != NONE; }
+
+            EntityHandle getHandle(unsigned int index) const { return EntityHandle(_slotOf[index], _slots[_slotOf[index]].generation); }
+
+            /** Slot of the entity at a dense index, stable for its lifetime */
+            uint32_t getSlot(unsigned int index) const { return _slotOf[index]; }
+
+            /** Dense index of the entity in a slot */
+            unsigned int getIndexOfSlot(uint32_t slot) const { return _slots[slot].index; }
+
+            unsigned int size() const { return _slotOf.size(); }
+            bool empty() const { return _slotOf.empty(); }
+
+            // COLUMNS (by dense index)
+            double* posX() { return _posX.data(); }
+            double* posY() { return _posY.data(); }
+            double* posZ() { return _posZ.data(); }
+
+            double* velX() { return _velX.data(); } // Blocks per tick
+            double* velY() { return _velY.data(); }
+            double* velZ() { return _velZ.data(); }
+
+            double* gravity() { return _gravity.data(); } // Blocks per tick per tick
+            double* drag()    { return _drag.data(); }    // Velocity multiplier per tick
+
+            unsigned short* type() { return _type.data(); }
+
+            uint32_t* flags() { return _flags.data(); } // For the modules, 0 on creation
+
+            const double* posX() const { return _posX.data(); }
+            const double* posY() const { return _posY.data(); }
+            const double* posZ() const { return _posZ.data(); }
+
+            const double* velX() const { return _velX.data(); }
+            const double* velY() const { return _velY.data(); }
+            const double* velZ() const { return _velZ.data(); }
+
+            const double* gravity() const { return _gravity.data(); }
+            const double* drag() const    { return _drag.data(); }
+
+            const unsigned short* type() const { return _type.data(); }
+
+            const uint32_t* flags() const { return _flags.data(); }
+
+            /** Per entity data of the modules, created on first use */
+            Metadata& getMetadata(unsigned int index);
+
+            // SIMULATION
+            /** Advances every entity by a tick: moves by the velocity, then applies gravity and drag */
+            void integrate();
+
+        protected:
+            struct Slot
+            {
+                uint32_t index;      // Dense index while alive, next free slot otherwise
+                uint32_t generation;
+            };
+
+            std::vector<Slot> _slots;
+
+            uint32_t _freeSlot; // Head of the free slots, NONE if there are none
+
+            std::vector<uint32_t> _slotOf; // By dense index
+
+            // Columns
+            std::vector<double> _posX, _posY, _posZ;
+            std::vector<double> _velX, _velY, _velZ;
+            std::vector<double> _gravity, _drag;
+
+            std::vector<unsigned short> _type;
+
+            std::vector<uint32_t> _flags;
+
+            std::vector<Metadata*> _metadata; // NULL until used
+
+        private:
+            EntityStore(const EntityStore& orig);
+            EntityStore& operator=(const EntityStore& orig);
+    };
+}
+
+#endif //ENTITYSTORE_INCLUDED
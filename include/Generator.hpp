@@ -42,6 +42,9 @@ extern "C"
 
 	/**
 	 * Provides a chunk.
+	 * May be called from several worker threads at once.
+	 * Chunks are allocated with new, the core deletes them.
+	 * Uniform chunks should be returned as Chunk::getShared.
 	 *
 	 * @param x X chunk coord.
 	 * @param y Y chunk coord.
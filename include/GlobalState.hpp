@@ -8,16 +8,39 @@
 #define GLOBALSTATE_INCLUDED
 
 #include "Chunk.hpp"
+#include "ChunkCache.hpp"
+#include "ChunkIndex.hpp"
+#include "ChunkPrefetcher.hpp"
+#include "ChunkRequests.hpp"
+#include "ChunkTickets.hpp"
+#include "Entity.hpp"
+#include "EntityIndex.hpp"
+#include "EntityStore.hpp"
+#include "Point3D.hpp"
 #include "Action.hpp"
+#include "ActionArena.hpp"
+#include "ActionQueue.hpp"
+#include "AutoSaver.hpp"
+#include "BlockProperties.hpp"
+#include "BlockUpdateScheduler.hpp"
+#include "RandomTicker.hpp"
 
 #include "Metadata.hpp"
 
 #include "Module.hpp"
+#include "Registry.hpp"
+
+#include "ThreadPool.hpp"
+#include "TickProfiler.hpp"
+#include "TickScheduler.hpp"
+#include "Tracer.hpp"
+#include "UpdateWheel.hpp"
 
 // STL
 #include <map>
 #include <queue>
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 // C
@@ -25,6 +48,7 @@
 
 // C++11
 #include <chrono>
+#include <mutex>
 #include <thread>
 
 /**
@@ -34,28 +58,6 @@
 
 namespace EJV
 {
-    struct Point3D
-    {
-        Point3D() {}
-        Point3D(int _x, int _y, int _z) : x(_x), y(_y), z (_x) {}
-
-        int x, y, z;
-
-        virtual bool operator<(const Point3D& point) const
-        {
-            return x < point.x && y < point.y && z < point.z;
-        }
-    };
-
-    struct Entity : public Metadata
-    {
-        unsigned short type;
-
-        // TODO: Dynamic ownership
-
-        double posX, posY, posZ;
-    };
-
 	struct World : public Metadata
 	{
 	    // Name
@@ -64,19 +66,44 @@ namespace EJV
 
 		// Entities
 
-		typedef std::list<Entity*> EntityList;
+		EntityStore entities; // State of every entity by field, see spawnEntity
 
-		EntityList entities;
+		EntityIndex entityIndex; // Entities by position, for collisions, targeting or spawn caps
 
 		// Chunks
 
-		typedef std::map<Point3D, Chunk*> ChunkMap;
-
-		typedef std::list<std::pair<Point3D, Chunk*> > ChunkUpdatesList;
+		typedef ChunkIndex ChunkMap;
 
 		ChunkMap loadedChunks;
 
-		ChunkUpdatesList chunkUpdates;
+		UpdateWheel updateWheel; // When chunks have scheduled updates due
+
+		BlockUpdateScheduler blockUpdates;
+
+		BlockUpdateScheduler::BlockList deferredUpdates; // Waiting for chunks they reach, run first on the next update
+
+		RandomTicker randomTicker;
+
+		ChunkCache cache;
+
+		ChunkRequests requests;
+
+		ChunkTickets tickets;
+
+		std::unordered_map<ChunkIndex::Key, ChunkTickets::ID> updateTickets; // TICKET_BLOCK_UPDATE of the chunks with scheduled updates
+
+		struct EntityTicket
+		{
+		    ChunkTickets::ID id;
+
+		    Point3D chunk; // Center, the chunk the entity was in
+		};
+
+		std::unordered_map<uint32_t, EntityTicket> entityTickets; // By entity slot, for the types with a ticket radius
+
+		std::mutex scheduleMutex; // Parallel block updates schedule updates, held by scheduleUpdate around updateWheel, tickets and updateTickets
+
+		ChunkPrefetcher prefetcher;
 
 		// Modules
 
@@ -88,10 +115,27 @@ namespace EJV
 
 		uint64_t ticks;
 
+		bool overloaded; // Set while ticks run over budget, optional work is skipped or stretched
+
+		// Profiling
+
+		struct Phases
+		{
+		    TickProfiler::PhaseID update, install, blocks, entities, prefetch, unload, autosave, evict;
+
+		    TickProfiler::PhaseID load, save; // Any thread
+		};
+
+		Phases phases; // Named "<world name>/<phase>"
+
+		// Saving
+
+		AutoSaver autosaver; // Last, its writer uses the members above until it is destroyed
+
 		// Functions
 
 		/** Sets the world's name. */
-		World(const std::string& name) : worldName(name) {}
+		World(const std::string& name);
 
 		/** Initializes the loader/generator.*/
         void initProviders();
@@ -103,22 +147,120 @@ namespace EJV
          */
 		Chunk* getChunk(const Point3D& point);
 
+		/** Fetches a chunk for writing, replacing a shared chunk by a private copy */
+		Chunk* editChunk(const Point3D& point);
+
+		/** Block at world block coordinates */
+		Chunk::BlockID getBlock(const Point3D& block);
+
+		/** Sets a block at world block coordinates */
+		void setBlock(const Point3D& block, Chunk::BlockID id);
+
+        /** \brief Requests a chunk without blocking the tick
+         *
+         * Loading and generation run on the worker pool. The callback runs
+         * on the tick thread once the chunk is installed, or right away if
+         * it is loaded already (then returns true).
+         *
+         */
+		bool requestChunk(const Point3D& point, ChunkCallback callback = 0, void* data = 0);
+
+		/** Installs the chunks finished by the workers and runs their callbacks */
+		void installChunks();
+
+		/** Loads or generates a chunk without caching it (thread safe) */
+		Chunk* provideChunk(const Point3D& point);
+
 		/** Loads a chunk from the disk (Discards any unsaved changes) */
 		Chunk* loadChunk(const Point3D& point);
 
 		/** Unloads and saves chunk */
 		void unloadChunk(const Point3D& point);
 
-        /** Saves world to disk */
-        void saveWorld() const;
+		/** Frees a provided chunk that never became or no longer is resident, without saving it */
+		void discardChunk(const Point3D& point, Chunk* chunk);
+
+		/** Unloads least recently used chunks while over the cache's memory budget */
+		void evictChunks();
+
+		/** \brief Keeps the chunks around center resident
+		 *
+		 * Chunks within radius (in chunks, on every axis) are requested
+		 * right away. A duration of 0 keeps the ticket until it is removed.
+		 *
+		 */
+		ChunkTickets::ID addTicket(TicketType type, TicketLevel level, const Point3D& center, unsigned int radius, unsigned int duration = 0);
+
+		/** Requests the chunks the entities are about to need */
+		void prefetchChunks();
+
+		/** Recenters a ticket, e.g. when a player moves to another chunk */
+		void moveTicket(ChunkTickets::ID id, const Point3D& center);
+
+		/** Removes a ticket, unloading the chunks nothing else holds */
+		void removeTicket(ChunkTickets::ID id);
+
+        /** Saves the changed chunks to disk, returns how many were written */
+        unsigned int saveWorld();
+
+        /** \brief Schedules a block update delay ticks from now
+         *
+         * A block has at most one pending update, later requests are
+         * ignored (returns false). Within each BlockUpdateScheduler region,
+         * due updates run ordered by tick, then priority (lowest first),
+         * then position. A delay of 0 runs on the next update. Chunks
+         * with pending updates hold a TICKET_BLOCK_UPDATE ticket and stay
+         * resident until their updates ran.
+         *
+         */
+        bool scheduleUpdate(const Point3D& block, unsigned int delay = 0, int priority = 0);
+
+        /** Registers the scheduled updates of a chunk that became resident */
+        void wakeScheduledUpdates(const Point3D& point, const Chunk* chunk);
+
+        /** Takes or drops the TICKET_BLOCK_UPDATE of a chunk, whether it has scheduled updates */
+        void holdScheduledUpdates(const Point3D& point, const Chunk* chunk);
+
+        /** Collects the scheduled updates due this tick, in order */
+        void takeDueUpdates(BlockUpdateScheduler::BlockList& blocks);
+
+        /** \brief Adds an entity of a registered type, at rest
+         *
+         * It falls and slows down with the gravity and drag of its type.
+         * Whoever moves entities outside of the update tells entityIndex.
+         * Returns a null handle if the type isn't registered.
+         *
+         */
+        EntityHandle spawnEntity(unsigned short type, double x, double y, double z);
+
+        /** Removes an entity and its ticket, stale handles are ignored */
+        void despawnEntity(EntityHandle entity);
+
+        /** Moves the tickets of the entities that changed chunks */
+        void moveEntityTickets();
+
+        /** \brief Holds back the updates reaching chunks that aren't loaded
+         *
+         * For passes running on the workers, which must not load chunks.
+         * The missing chunks are requested and the updates moved to
+         * deferredUpdates. Returns true if any update was held back.
+         *
+         */
+        bool deferUnloadedReach(BlockUpdateScheduler::BlockList& blocks);
+
+        /** Picks the random ticks of the chunks ticketed for ticking (players' tickets, see EntityInfo::ticketRadius) */
+        void takeRandomTicks(BlockUpdateScheduler::BlockList& blocks);
 
         /** Updates chunks */
         void update();
 
-        /** Updates a block */
-        void updateBlock(Chunk* chunk, const Point3D& point);
+        /** Updates a block at world block coordinates (may run on a worker, see BlockUpdateScheduler) */
+        void updateBlock(const Point3D& block);
 	};
 
+	/** Splits world block coordinates into chunk and in-chunk coordinates */
+	void splitBlockPosition(const Point3D& block, Point3D& chunk, Point3D& local);
+
 	struct Location
 	{
 	    World* world;
@@ -135,9 +277,19 @@ namespace EJV
 
 	    double hardness;
 
-	    BlockInfo() {}
+	    bool randomTicks; // Also runs updateFunc on random ticks (crops, grass, ...)
+
+	    // Copied to State::blockProperties when registering
+	    bool solid;
+	    bool opaque;
+	    bool replaceable;
+
+	    unsigned char light; // Emitted light level, 0 to 15
 
-	    BlockInfo(const double& _hardness) : hardness(_hardness) {}
+	    BlockInfo() : updateFunc(0), hardness(0), randomTicks(false), solid(true), opaque(true), replaceable(false), light(0) {}
+
+	    BlockInfo(const double& _hardness, bool _randomTicks = false) : updateFunc(0), hardness(_hardness), randomTicks(_randomTicks),
+	                                                                    solid(true), opaque(true), replaceable(false), light(0) {}
 	};
 
 	/** Stores information about an item */
@@ -151,16 +303,16 @@ namespace EJV
 
 	    double attackStrength;
 
-	    ItemInfo() {}
+	    ItemInfo() : updateFunc(0), maxDurability(0), attackStrength(0) {}
 
 	    ItemInfo(const double& _maxDurability,
-                 const double& _attackStrength) : maxDurability(_maxDurability), attackStrength(_attackStrength) {}
+                 const double& _attackStrength) : updateFunc(0), maxDurability(_maxDurability), attackStrength(_attackStrength) {}
 	};
 
 	/** Stores information about an entity */
 	struct EntityInfo
 	{
-	    typedef void (*UpdateFunction)(World* world, Entity* entity, EntityInfo& info);
+	    typedef void (*UpdateFunction)(World* world, EntityHandle entity, EntityInfo& info);
 
 	    UpdateFunction updateFunc; // If null, use the standard item update function
 
@@ -168,7 +320,13 @@ namespace EJV
 
 	    double attackStrength;
 
-	    EntityInfo() {}
+	    double gravity; // Blocks per tick per tick
+	    double drag;    // Velocity multiplier per tick
+
+	    unsigned int ticketRadius; // Chunks around the entity kept entity ticking, 0 for none
+	    TicketType ticketType;     // TICKET_PLAYER or TICKET_ENTITY
+
+	    EntityInfo() : updateFunc(0), maxHealth(0), attackStrength(0), gravity(0.08), drag(0.98), ticketRadius(0), ticketType(TICKET_ENTITY) {}
 	};
 
 	class State : public Metadata
@@ -178,7 +336,7 @@ namespace EJV
             static State *_singleton;
 
             // Private constructors / destructors
-            State() {}
+            State() : _workers(0), _parallelWorlds(false), _ticks(0) { _tickPhase = profiler.getPhase("tick"); }
             State(const State& orig) {}
             virtual ~State() {}
             State& operator=(const State& orig) { return *this; }
@@ -190,44 +348,138 @@ namespace EJV
             RuleModuleList _rules;
             UIModuleList   _uis;
 
+            std::vector<TickProfiler::PhaseID> _rulePhases; // In _rules order
+
+            TickProfiler::PhaseID _tickPhase;
+
+            // Threads
+
+            ThreadPool* _workers;
+
+            std::once_flag _workersCreated;
+
+            bool _parallelWorlds;
+
             // Timing
 
-            unsigned int _tickDuration;
+            TickScheduler _scheduler;
 
             uint64_t _ticks;
 
-            std::chrono::steady_clock::time_point _before;
+            // Actions
+
+            ActionQueue::ActionList _actionBatch;  // Drained at the start of the tick
+            ActionQueue::ActionList _moduleBatch;  // Actions of _actionBatch a module subscribed to
 
             // Functions
 
             bool gameTick();
 
+            /** Hands the action batch to the rule modules subscribed to them */
+            void dispatchActions();
+
 		public:
             typedef std::vector<World*> WorldList;
-            typedef std::list<Action::Base*> ActionList;
 
             typedef unsigned short ID;
 
             WorldList loadedWorlds;
-            ActionList actions;
+
+            /** Actions waiting for the next tick, any thread may push */
+            ActionQueue actions;
+
+            /** Memory of the queued actions, released after they were dispatched */
+            ActionArena actionArena;
+
+            // Indexed by block IDs, ItemInfo and EntityInfo IDs
+            Registry<BlockInfo>  blocks;
+            Registry<ItemInfo>   items;
+            Registry<EntityInfo> entities;
+
+            BlockProperties blockProperties; // Flags of the registered blocks by block ID
+
+            /** Time spent per tick phase over the last ticks, see dump() */
+            TickProfiler profiler;
 
             // MUST NOT BE INLINED
             static State &GET();
 
+            /** Runs ticks until gameTick() stops, then saves every world */
             void run();
 
+            // THREADS
+            /** Shared worker pool, started on first use */
+            ThreadPool& getWorkers();
+
+            /**
+             * \brief Updates the loaded worlds concurrently on the worker pool
+             *
+             * All worlds finish their update before the rule modules run.
+             * While worlds update, they may only read the registries and
+             * metadata, use getWorkers() and the tick/timing getters.
+             * Registering modules, types or metadata, touching loadedWorlds or
+             * other worlds is not allowed from World::update, pushing actions is.
+             * Worlds may share a LoaderModule, every call into it holds its
+             * mutex. A loader library must only be loaded once: its state is
+             * global to the process, two LoaderModule of the same library
+             * would not lock each other out.
+             *
+             */
+            void setParallelWorlds(bool enable) { _parallelWorlds = enable; }
+            bool getParallelWorlds() const { return _parallelWorlds; }
+
             // MODULES
             void registerRuleModule(RuleModule* module);
             void registerUIModule(UIModule* module);
 
+            // ACTIONS
+            /**
+             * \brief Queues a player action for the rule modules (thread safe)
+             *
+             * The action must have been made by the writer, which stays on
+             * the arena half until the push is done. It is dispatched during
+             * the next tick and released afterwards. Returns false if the
+             * queue is full, the caller should drop the action or retry later.
+             * Throws if the writer belongs to another arena than actionArena.
+             *
+             */
+            bool pushAction(const ActionArena::Writer& writer, Action::Base* action);
+
+            /** Makes an action in the arena and queues it, see above */
+            template <typename T, typename... Args>
+            bool pushAction(Args&&... args)
+            {
+                ActionArena::Writer writer(actionArena);
+
+                return pushAction(writer, writer.make<T>(std::forward<Args>(args)...));
+            }
+
+            // REGISTRIES
+            /** Registers a block type and its properties, returns its block ID */
+            ID registerBlock(const BlockInfo& info);
+            ID registerItem(const ItemInfo& info)     { return items.add(info); }
+            ID registerEntity(const EntityInfo& info) { return entities.add(info); }
+
             // SIMULATION SPEED
-            unsigned int getTickDuration() const { return _tickDuration; }
-            double       getTickDurationSeconds() const { return _tickDuration / 1000.0; }
+            /** Milliseconds per tick, 50 by default, 0 runs ticks back to back */
+            unsigned int getTickDuration() const
+            {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(_scheduler.getTickDuration()).count();
+            }
+
+            double getTickDurationSeconds() const { return std::chrono::duration<double>(_scheduler.getTickDuration()).count(); }
 
-            void setTickDuration(const unsigned int& speed)  { _tickDuration = speed; }
-            void setTickDurationSeconds(const double& speed) { _tickDuration = speed * 1000.0; }
+            void setTickDuration(const unsigned int& speed) { _scheduler.setTickDuration(std::chrono::milliseconds(speed)); }
+
+            void setTickDurationSeconds(const double& speed)
+            {
+                _scheduler.setTickDuration(std::chrono::duration_cast<TickScheduler::Clock::duration>(std::chrono::duration<double>(speed)));
+            }
 
             uint64_t getTicks() const { return _ticks; }
+
+            /** Pacing settings and lateness statistics, watch getStats().lateness to alert on lag */
+            TickScheduler& getScheduler() { return _scheduler; }
 	};
 }
 
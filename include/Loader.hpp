@@ -53,6 +53,9 @@ extern "C"
 
 	/**
 	 * Saves a chunk to the disc.
+	 * Must include its scheduled updates (Chunk::getScheduledUpdates), their
+	 * ticks are absolute world ticks, and restore them in loadChunk.
+	 * Chunks unloaded or saved at shutdown keep them that way.
 	 *
 	 * @param x X chunk coord.
 	 * @param y Y chunk coord.
@@ -63,6 +66,11 @@ extern "C"
 
 	/**
 	 * Releases a chunk.
+	 * Called after the chunk was saved, once the core no longer
+	 * keeps it resident. The core frees the chunk afterwards.
+	 * Every loadChunk call is matched by exactly one releaseChunk, also
+	 * for generated chunks and copies the core discarded right away;
+	 * c is NULL if neither loading nor generating produced a chunk.
 	 *
 	 * @param x X chunk coord.
 	 * @param y Y chunk coord.
@@ -27,7 +27,7 @@ namespace EJV
 	    template <typename T>
 	    inline T& getMetadata(unsigned int id)
 	    {
-            if (id > data.size()) throw std::runtime_error("Out of range");
+            if (id >= data.size()) throw std::runtime_error("Out of range");
 
             T* ptr = (T*) data[id];
 
@@ -4,9 +4,13 @@
 #include <cstring>
 #include <string>
 
+// C++11
+#include <mutex>
+
 #include "Action.hpp"
 #include "Chunk.hpp"
 #include "Menu.hpp"
+#include "Metadata.hpp"
 
 namespace EJV
 {
@@ -17,6 +21,8 @@ namespace EJV
         protected:
             void* _handle;
 
+            std::string _path;
+
         public:
             SharedLibrary() : _handle(0) {}
 
@@ -27,6 +33,9 @@ namespace EJV
             void unload();
 
             void* fetchFunctionPointer(const std::string& name);
+
+            /** Path the library was loaded from */
+            const std::string& getPath() const { return _path; }
     };
 
     struct Module : public SharedLibrary
@@ -43,8 +52,14 @@ namespace EJV
     struct RuleModule : public Module
     {
         typedef void (*TickFunc)(Action::Base*);
+        typedef void (*TickActionsFunc)(Action::Base* const* actions, unsigned int count);
+        typedef ActionMask (*GetActionMaskFunc)();
 
-        TickFunc tick;
+        TickFunc tick;                 // Called once per action
+        TickActionsFunc tickActions;   // Called once per tick with every action, preferred over tick
+        GetActionMaskFunc getActionMask;
+
+        ActionMask actionMask; // Action types dispatched to the module
 
         virtual void loadFunctions();
     };
@@ -80,6 +95,8 @@ namespace EJV
         GetMetadataFunc getMetadata;
         SetMetadataFunc setMetadata;
 
+        std::mutex mutex; // Loaders keep process wide state and aren't thread safe, held around every call
+
         virtual void loadFunctions();
     };
 
@@ -0,0 +1,37 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef POINT3D_INCLUDED
+#define POINT3D_INCLUDED
+
+/**
+ * @file Integer coordinates
+ *
+ */
+
+namespace EJV
+{
+    struct Point3D
+    {
+        Point3D() {}
+        Point3D(int _x, int _y, int _z) : x(_x), y(_y), z(_z) {}
+
+        int x, y, z;
+
+        bool operator<(const Point3D& point) const
+        {
+            if (x != point.x) return x < point.x;
+            if (y != point.y) return y < point.y;
+
+            return z < point.z;
+        }
+
+        bool operator==(const Point3D& point) const { return x == point.x && y == point.y && z == point.z; }
+        bool operator!=(const Point3D& point) const { return !(*this == point); }
+    };
+}
+
+#endif //POINT3D_INCLUDED
@@ -0,0 +1,102 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef RANDOMTICKER_INCLUDED
+#define RANDOMTICKER_INCLUDED
+
+#include "BlockProperties.hpp"
+#include "Chunk.hpp"
+#include "Point3D.hpp"
+
+// STL
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * @file Random block ticks
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Picks the blocks receiving a random tick (crop growth, grass
+     * spread, leaf decay, ...).
+     *
+     * Every tick, each ticking chunk gets `speed` blocks picked at random.
+     * A chunk ticks while a ticket of TICKET_LEVEL_TICKING or above covers
+     * it, such as the ones kept around players.
+     * Chunks whose palette holds no random ticking block type (per the
+     * block property table) are skipped without drawing a single number,
+     * which is what keeps large worlds of stone and air cheap.
+     *
+     * The numbers come from a hash of the seed, the chunk and the tick,
+     * so there is no state to keep per chunk and runs are reproducible.
+     */
+    class RandomTicker
+    {
+        public:
+            struct Stats
+            {
+                unsigned int chunks;  // Considered
+                unsigned int skipped; // No random ticking block type
+                unsigned int picked;  // Blocks that got a tick
+
+                Stats() : chunks(0), skipped(0), picked(0) {}
+            };
+
+            RandomTicker(const BlockProperties& properties) : _properties(properties), _speed(3), _seed(0) {}
+
+            // SETTINGS
+            /** Blocks picked per chunk and tick, 0 disables random ticks */
+            void setSpeed(unsigned int blocks) { _speed = blocks; }
+            unsigned int getSpeed() const { return _speed; }
+
+            void setSeed(uint64_t seed) { _seed = seed; }
+            uint64_t getSeed() const { return _seed; }
+
+            // BLOCK TYPES
+            /** Whether a block type takes random ticks (BlockInfo::randomTicks) */
+            bool isTickable(Chunk::BlockID id) const { return _properties.has(id, BlockProperties::TICKABLE); }
+
+            /** Whether any palette entry of a chunk takes random ticks */
+            bool hasTickable(const Chunk& chunk) const;
+
+            // TICKING
+            /** Starts a tick's statistics */
+            void begin() { _stats = Stats(); }
+
+            /** Counts a chunk, false if it has nothing to tick (check this first, it's the cheapest) */
+            bool consider(const Chunk& chunk)
+            {
+                ++_stats.chunks;
+
+                if (_speed && hasTickable(chunk)) return true;
+
+                ++_stats.skipped;
+
+                return false;
+            }
+
+            /** Appends the world positions of a chunk's blocks getting a tick */
+            void select(const Point3D& point, const Chunk& chunk, uint64_t tick, std::vector<Point3D>& blocks);
+
+            /** Statistics of the current or last tick */
+            const Stats& getStats() const { return _stats; }
+
+        protected:
+            const BlockProperties& _properties;
+
+            unsigned int _speed;
+
+            uint64_t _seed;
+
+            Stats _stats;
+    };
+}
+
+#endif //RANDOMTICKER_INCLUDED
@@ -0,0 +1,80 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef REGISTRY_INCLUDED
+#define REGISTRY_INCLUDED
+
+#include <stdexcept>
+#include <vector>
+
+#include <cassert>
+
+/**
+ * @file Dense typed registries
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Contiguous array of one kind of information (blocks, items,
+     * entities), indexed by small IDs handed out in registration order.
+     *
+     * IDs never change. Registering may move the entries, so it only
+     * happens while modules initialize, never while worlds update.
+     */
+    template <typename T>
+    class Registry
+    {
+        public:
+            typedef unsigned short ID;
+
+            /** Stores a copy of the information, returns its ID */
+            ID add(const T& info)
+            {
+                if (_entries.size() > ID(~0)) throw std::runtime_error("Registry full");
+
+                _entries.push_back(info);
+
+                return _entries.size() - 1;
+            }
+
+            /** Unchecked lookup for hot paths (asserts in debug builds) */
+            inline T& operator[](ID id)
+            {
+                assert(id < _entries.size());
+
+                return _entries[id];
+            }
+
+            inline const T& operator[](ID id) const
+            {
+                assert(id < _entries.size());
+
+                return _entries[id];
+            }
+
+            /** Checked lookup, throws for IDs nobody registered */
+            T& at(ID id)
+            {
+                if (id >= _entries.size()) throw std::runtime_error("Unregistered ID");
+
+                return _entries[id];
+            }
+
+            /** The entry of an ID, NULL if nobody registered it */
+            inline T* find(ID id) { return id < _entries.size() ? &_entries[id] : 0; }
+
+            inline bool has(ID id) const { return id < _entries.size(); }
+
+            unsigned int size() const { return _entries.size(); }
+
+        protected:
+            std::vector<T> _entries;
+    };
+}
+
+#endif //REGISTRY_INCLUDED
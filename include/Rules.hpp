@@ -37,10 +37,29 @@ extern "C"
 
 	/**
 	 * Ticks each rules module. Used for simulation/physics.
+	 * Called once per action, optional if tickActions is exported.
 
 	 * @param act List of actions that players have taken.
 	 */
 	void tick(EJV::Action::Base *act);
+
+	/**
+	 * Hands the module all actions of a tick at once,
+	 * in the order they were taken. Only called if at
+	 * least one of them matches getActionMask.
+	 *
+	 * @param acts Actions of the subscribed types.
+	 * @param count Number of actions.
+	 */
+	void tickActions(EJV::Action::Base *const *acts, unsigned int count);
+
+	/**
+	 * Optional, action types the module handles
+	 * (EJV::actionBit of each). Every type by default.
+	 *
+	 * @return Mask of the subscribed action types.
+	 */
+	EJV::ActionMask getActionMask();
 }
 
 // EXTERNAL
@@ -0,0 +1,101 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef SCHEDULEDUPDATES_INCLUDED
+#define SCHEDULEDUPDATES_INCLUDED
+
+#include <vector>
+
+#include <cstddef>
+
+#include <stdint.h>
+
+/**
+ * @file Block updates scheduled within a chunk
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Pending block updates of one chunk, keyed by local block index
+     * (Chunk::index) with a target world tick and a priority.
+     *
+     * A block has at most one pending update; scheduling it again before
+     * it ran is ignored. Updates come out ordered by tick, then priority
+     * (lowest first), then index, so draining is deterministic.
+     *
+     * The list is part of the chunk and copied with it, loaders store it
+     * with the chunk (the Anvil loader does). The world also keeps chunks
+     * with pending updates resident so they run on time.
+     */
+    class ScheduledUpdates
+    {
+        public:
+            struct Entry
+            {
+                uint64_t tick;
+
+                int priority;
+
+                unsigned short index;
+
+                bool operator<(const Entry& e) const
+                {
+                    if (tick != e.tick) return tick < e.tick;
+                    if (priority != e.priority) return priority < e.priority;
+
+                    return index < e.index;
+                }
+            };
+
+            typedef std::vector<Entry> EntryList;
+
+            typedef EntryList::const_iterator const_iterator;
+
+            ScheduledUpdates() : _modCount(0) {}
+
+            // SCHEDULING
+            /** Schedules an update, returns false if the block has one pending already */
+            bool schedule(unsigned int index, uint64_t tick, int priority = 0);
+
+            bool isScheduled(unsigned int index) const
+            {
+                return !_pending.empty() && (_pending[index / 64] >> (index % 64)) & 1;
+            }
+
+            /** Earliest pending tick, only valid while not empty */
+            uint64_t getNextTick() const { return _heap.front().tick; }
+
+            /** Removes the updates due by tick, appending them in order */
+            void popDue(uint64_t tick, EntryList& due);
+
+            void clear();
+
+            // INFO
+            unsigned int size() const { return _heap.size(); }
+
+            bool empty() const { return _heap.empty(); }
+
+            /** Incremented by every change */
+            uint32_t getModificationCount() const { return _modCount; }
+
+            size_t getMemoryUsage() const { return _heap.capacity() * sizeof(Entry) + _pending.capacity() * sizeof(uint64_t); }
+
+            /** Iterates over the pending updates in no particular order (for saving) */
+            const_iterator begin() const { return _heap.begin(); }
+            const_iterator end() const   { return _heap.end(); }
+
+        protected:
+            EntryList _heap; // Binary min-heap
+
+            std::vector<uint64_t> _pending; // One bit per block, allocated with the first update
+
+            uint32_t _modCount;
+    };
+}
+
+#endif //SCHEDULEDUPDATES_INCLUDED
@@ -0,0 +1,77 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef THREADPOOL_INCLUDED
+#define THREADPOOL_INCLUDED
+
+// STL
+#include <deque>
+#include <vector>
+
+// C++11
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file Worker threads
+ *
+ */
+
+namespace EJV
+{
+    /** Fixed set of threads running jobs in submission order */
+    class ThreadPool
+    {
+        public:
+            typedef std::function<void()> Job;
+
+            /** Starts the workers, 0 picks one less than the number of cores (at least 1) */
+            ThreadPool(unsigned int threads = 0);
+
+            /** Finishes the queued jobs and joins the workers */
+            ~ThreadPool();
+
+            void submit(const Job& job);
+
+            /**
+             * Runs body(0) to body(count - 1) across the workers and the
+             * calling thread, returning once all of them have finished.
+             * Other queued jobs are not waited for.
+             */
+            void parallelFor(unsigned int count, const std::function<void(unsigned int)>& body);
+
+            /** Blocks until every submitted job has finished */
+            void wait();
+
+            unsigned int size() const { return _threads.size(); }
+
+        protected:
+            std::vector<std::thread> _threads;
+
+            std::deque<Job> _jobs;
+
+            std::mutex _mutex;
+
+            std::condition_variable _wake;
+            std::condition_variable _idle;
+
+            unsigned int _active;
+
+            bool _stop;
+
+            void work();
+
+        private:
+            ThreadPool(const ThreadPool& orig);
+            ThreadPool& operator=(const ThreadPool& orig);
+    };
+}
+
+#endif //THREADPOOL_INCLUDED
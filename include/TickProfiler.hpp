@@ -0,0 +1,169 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef TICKPROFILER_INCLUDED
+#define TICKPROFILER_INCLUDED
+
+// STL
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// C++11
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+/**
+ * @file Time spent per tick phase
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Records how long each phase of a tick took, for the last N ticks.
+     *
+     * Phases are registered by name and get a small ID. Scopes add their
+     * duration to the current tick's frame (any thread, phases may run
+     * several times per tick); endTick() moves the frame into a ring
+     * buffer. The ring is written by the tick thread only and can be read
+     * from any thread without locks, readers skip the slot being written.
+     *
+     * Counters are allocated in pages of PAGE_PHASES phases as phases get
+     * registered, pages are never moved or freed before the profiler.
+     */
+    class TickProfiler
+    {
+        public:
+            typedef unsigned int PhaseID;
+
+            typedef std::chrono::steady_clock Clock;
+
+            static const unsigned int PAGE_PHASES = 64;
+            static const unsigned int MAX_PAGES = 64;
+
+            static const unsigned int MAX_PHASES = PAGE_PHASES * MAX_PAGES;
+
+            struct Summary
+            {
+                std::string name;
+
+                unsigned int samples; // Ticks in the history
+
+                // Milliseconds per tick
+                double mean;
+                double p50;
+                double p99;
+                double max;
+            };
+
+            typedef std::vector<Summary> SummaryList;
+
+            /** Times a scope into a phase */
+            class Scope
+            {
+                public:
+                    Scope(TickProfiler& profiler, PhaseID phase) : _profiler(profiler), _phase(phase)
+                    {
+                        if (profiler.isEnabled()) _start = Clock::now();
+                    }
+
+                    ~Scope()
+                    {
+                        if (_profiler.isEnabled() && _start != Clock::time_point()) _profiler.record(_phase, Clock::now() - _start);
+                    }
+
+                protected:
+                    TickProfiler& _profiler;
+
+                    PhaseID _phase;
+
+                    Clock::time_point _start;
+            };
+
+            TickProfiler(unsigned int history = 1200);
+
+            ~TickProfiler();
+
+            // SETTINGS
+            void setEnabled(bool enable) { _enabled.store(enable, std::memory_order_relaxed); }
+            bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+            unsigned int getHistory() const { return _history; }
+
+            // PHASES
+            /** ID of the phase with that name, registering it if needed */
+            PhaseID getPhase(const std::string& name);
+
+            std::string getPhaseName(PhaseID phase) const;
+
+            unsigned int getPhaseCount() const { return _phaseCount.load(std::memory_order_acquire); }
+
+            // RECORDING
+            /** Adds time to a phase of the current tick (thread safe) */
+            inline void record(PhaseID phase, Clock::duration duration)
+            {
+                Counter* page = _current[phase / PAGE_PHASES].load(std::memory_order_acquire);
+
+                page[phase % PAGE_PHASES].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+            }
+
+            /** Tick thread: stores the current frame as the latest tick */
+            void endTick();
+
+            /** Number of ticks recorded so far */
+            uint64_t getTickCount() const { return _head.load(std::memory_order_acquire); }
+
+            // READING
+            /** Per phase percentiles over the history (any thread) */
+            void summarize(SummaryList& summaries) const;
+
+            /** Writes the summaries as a table */
+            void dump(std::ostream& out) const;
+
+            /** Writes the summaries to a file, false if it couldn't be opened */
+            bool dump(const std::string& path) const;
+
+        protected:
+            typedef std::atomic<uint64_t> Counter;
+
+            struct Slot
+            {
+                std::atomic<uint64_t> sequence; // Odd while being written, 0 if never written
+
+                std::atomic<Counter*> pages[MAX_PAGES]; // Nanoseconds by phase, added by endTick as needed
+            };
+
+            const unsigned int _history;
+
+            std::unique_ptr<Slot[]> _ring;
+
+            std::atomic<uint64_t> _head; // Ticks recorded
+
+            std::atomic<Counter*> _current[MAX_PAGES]; // Added by getPhase
+
+            std::atomic<bool> _enabled;
+
+            std::vector<std::string> _names; // Guarded by _mutex
+
+            std::atomic<unsigned int> _phaseCount;
+
+            mutable std::mutex _mutex;
+
+            /** A page of counters set to 0 */
+            static Counter* newPage();
+
+        private:
+            TickProfiler(const TickProfiler& orig);
+            TickProfiler& operator=(const TickProfiler& orig);
+    };
+}
+
+#endif //TICKPROFILER_INCLUDED
@@ -0,0 +1,109 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef TICKSCHEDULER_INCLUDED
+#define TICKSCHEDULER_INCLUDED
+
+#include <stdint.h>
+
+// C++11
+#include <chrono>
+
+/**
+ * @file Fixed timestep tick pacing
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Paces the game loop at a fixed timestep.
+     *
+     * Every tick has a deadline one tick duration after the previous one.
+     * wait() sleeps until shortly before the deadline and yields the rest
+     * of the way. A tick that finishes late makes the next ones start
+     * right away until the loop caught up, but never for more than
+     * maxCatchUp ticks: beyond that the missed ticks are dropped.
+     *
+     * When the average tick takes longer than the budget the scheduler
+     * reports an overload, the game then sheds optional work.
+     */
+    class TickScheduler
+    {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            struct Stats
+            {
+                uint64_t ticks;
+                uint64_t lateTicks;    // Started later than the tolerance
+                uint64_t droppedTicks; // Given up on while catching up
+
+                double lateness;    // How late the last tick started, in milliseconds
+                double maxLateness;
+                double busyTime;    // Time the last tick took, in milliseconds
+                double averageBusy; // Moving average of busyTime
+
+                bool overloaded;
+
+                Stats() : ticks(0), lateTicks(0), droppedTicks(0), lateness(0), maxLateness(0),
+                          busyTime(0), averageBusy(0), overloaded(false) {}
+            };
+
+            TickScheduler() : _duration(std::chrono::milliseconds(50)), _spinMargin(std::chrono::milliseconds(1)),
+                              _tolerance(std::chrono::milliseconds(5)), _maxCatchUp(10), _overloadPercent(90) {}
+
+            // SETTINGS
+            /** 0 (or less) runs ticks back to back, they are never dropped or overloaded */
+            void setTickDuration(Clock::duration duration) { _duration = duration; }
+            Clock::duration getTickDuration() const { return _duration; }
+
+            /** Time before a deadline spent yielding instead of sleeping, sleeps overshoot */
+            void setSpinMargin(Clock::duration margin) { _spinMargin = margin; }
+            Clock::duration getSpinMargin() const { return _spinMargin; }
+
+            /** Ticks starting later than this count as late */
+            void setLateTolerance(Clock::duration tolerance) { _tolerance = tolerance; }
+            Clock::duration getLateTolerance() const { return _tolerance; }
+
+            /** Ticks run back to back to catch up before dropping the rest */
+            void setMaxCatchUp(unsigned int ticks) { _maxCatchUp = ticks; }
+            unsigned int getMaxCatchUp() const { return _maxCatchUp; }
+
+            /** Overloaded while the average tick takes more than this share of the tick duration */
+            void setOverloadThreshold(unsigned int percent) { _overloadPercent = percent; }
+            unsigned int getOverloadThreshold() const { return _overloadPercent; }
+
+            // PACING
+            /** Makes the next tick due now */
+            void start();
+
+            /** Blocks until the next tick is due, then marks its start */
+            void wait();
+
+            /** Marks the end of the tick and schedules the next one */
+            void finish();
+
+            bool isOverloaded() const { return _stats.overloaded; }
+
+            const Stats& getStats() const { return _stats; }
+
+        protected:
+            Clock::duration _duration;
+            Clock::duration _spinMargin;
+            Clock::duration _tolerance;
+
+            unsigned int _maxCatchUp;
+            unsigned int _overloadPercent;
+
+            Clock::time_point _deadline;
+            Clock::time_point _started;
+
+            Stats _stats;
+    };
+}
+
+#endif //TICKSCHEDULER_INCLUDED
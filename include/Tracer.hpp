@@ -0,0 +1,171 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef TRACER_INCLUDED
+#define TRACER_INCLUDED
+
+#include "Point3D.hpp"
+
+// STL
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// C++11
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+/**
+ * @file Timeline capture in the trace event format
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Records spans (ticks, world updates, chunk I/O, module calls) on
+     * every thread during a capture window and writes them as trace
+     * event JSON, loadable in chrome://tracing or Perfetto.
+     *
+     * Outside a capture a span costs one relaxed atomic load. During a
+     * capture each thread appends to its own buffer, and the capture
+     * stops recording once it holds maxEvents spans.
+     *
+     * Span names and details are not copied, they must stay valid until
+     * the capture is written (literals, world names, module paths).
+     */
+    class Tracer
+    {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            /** Records a span from construction to destruction */
+            class Scope
+            {
+                public:
+                    Scope(const char* name, const char* detail = 0) : _name(0)
+                    {
+                        if (Tracer::isCapturing()) begin(name, detail);
+                    }
+
+                    Scope(const char* name, const Point3D& point) : _name(0)
+                    {
+                        if (Tracer::isCapturing())
+                        {
+                            begin(name, 0);
+
+                            _point = point;
+                            _hasPoint = true;
+                        }
+                    }
+
+                    ~Scope()
+                    {
+                        if (_name) Tracer::GET().record(*this);
+                    }
+
+                protected:
+                    friend class Tracer;
+
+                    const char* _name; // NULL if not recording
+                    const char* _detail;
+
+                    Clock::time_point _start;
+
+                    Point3D _point;
+
+                    bool _hasPoint;
+
+                    void begin(const char* name, const char* detail)
+                    {
+                        _name = name;
+                        _detail = detail;
+                        _hasPoint = false;
+                        _start = Clock::now();
+                    }
+            };
+
+            static Tracer& GET();
+
+            static bool isCapturing() { return _capturing.load(std::memory_order_relaxed); }
+
+            // CAPTURE
+            /** Drops the previous capture and starts recording */
+            void start(unsigned int maxEvents = 1000000);
+
+            /** Stops recording, the capture can be written afterwards */
+            void stop();
+
+            /** Writes the last capture as trace event JSON */
+            void write(std::ostream& out);
+
+            /** Writes the last capture to a file, false if it couldn't be opened */
+            bool write(const std::string& path);
+
+            /** Names the calling thread in the captures */
+            void nameThread(const std::string& name);
+
+            /** Spans not recorded because the capture was full */
+            uint64_t getDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+        protected:
+            struct Event
+            {
+                const char* name;
+                const char* detail;
+
+                int64_t start;    // Nanoseconds since the capture started
+                int64_t duration;
+
+                Point3D point;
+
+                bool hasPoint;
+            };
+
+            /** Events of one thread */
+            struct Buffer
+            {
+                unsigned int thread;
+
+                std::string name;
+
+                std::vector<Event> events; // Guarded by mutex, only contended while writing a capture
+
+                std::mutex mutex;
+            };
+
+            static Tracer* _singleton;
+
+            static std::atomic<bool> _capturing;
+
+            std::vector<std::shared_ptr<Buffer> > _buffers; // Guarded by _mutex
+
+            // Atomic as a capture may be restarted while other threads record
+            std::atomic<int64_t> _epoch; // Clock time of the capture start, in nanoseconds
+
+            std::atomic<unsigned int> _events;
+            std::atomic<unsigned int> _maxEvents;
+            std::atomic<uint64_t> _dropped;
+
+            std::mutex _mutex;
+
+            Tracer() : _epoch(0), _events(0), _maxEvents(0), _dropped(0) {}
+
+            Tracer(const Tracer&);
+            Tracer& operator=(const Tracer&);
+
+            /** Buffer of the calling thread */
+            Buffer& getBuffer();
+
+            void record(const Scope& scope);
+    };
+}
+
+#endif //TRACER_INCLUDED
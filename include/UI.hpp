@@ -65,9 +65,15 @@ EJV::Chunk *getChunk(int x, int y, int z);
 
 /**
  * Call used by UI to push a user action.
+ * Safe from any thread, the action is
+ * dispatched next tick. It must be made
+ * by an EJV::ActionArena::Writer on the
+ * core's arena that outlives the call.
  *
- * @param act An action the player mad.
+ * @param act An action the player made.
+ * @return False if the action queue is full,
+ *         the action is then left to the caller.
  */
-void userAction(EJV::Action *act);
+bool userAction(EJV::Action::Base *act);
 
 #endif //UI_INCLUDED
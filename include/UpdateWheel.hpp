@@ -0,0 +1,92 @@
+/*#****************************************************************#*
+ * Empty Juice Voxel: Minecraft clone by the Empty Juice Box Group  *
+ * www              : http://www.juicebox.ckef-worx.com             *
+ * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
+ *#****************************************************************#*/
+
+#ifndef UPDATEWHEEL_INCLUDED
+#define UPDATEWHEEL_INCLUDED
+
+#include "ChunkIndex.hpp"
+
+// STL
+#include <map>
+#include <vector>
+
+// C++11
+#include <mutex>
+
+/**
+ * @file Wake up times of chunks with scheduled updates
+ *
+ */
+
+namespace EJV
+{
+    /**
+     * Hierarchical timing wheel of chunk wake ups.
+     *
+     * The first level has a slot per tick for the current 256 tick
+     * span, the second a slot per 256 ticks for the current 65536 tick
+     * span, anything later waits in an ordered overflow map. Slots cascade
+     * down as time reaches them, so scheduling and advancing stay O(1)
+     * per wake up no matter how far ahead updates are scheduled.
+     *
+     * Wake ups are hints: a chunk may wake when it has nothing due (it
+     * was unloaded or rescheduled), the world simply checks it.
+     * add() may be called from block updates running on the workers.
+     */
+    class UpdateWheel
+    {
+        public:
+            typedef ChunkIndex::Key Key;
+
+            typedef std::vector<Key> KeyList;
+
+            static const unsigned int SLOT_BITS = 8;
+            static const unsigned int SLOTS = 1 << SLOT_BITS;
+
+            UpdateWheel() : _now(0), _size(0) {}
+
+            /** Wakes a chunk at a tick, past ticks wake on the next advance */
+            void add(Key chunk, uint64_t tick);
+
+            /** Moves time forward, appending the chunks due by tick (sorted, unique) */
+            void advance(uint64_t tick, KeyList& due);
+
+            void clear();
+
+            uint64_t getTime() const { return _now; }
+
+            /** Number of pending wake ups, including stale ones */
+            unsigned int size() const { return _size; }
+
+        protected:
+            struct Timer
+            {
+                Key chunk;
+
+                uint64_t tick;
+            };
+
+            typedef std::vector<Timer> TimerList;
+
+            KeyList _near[SLOTS]; // Tick by tick
+            TimerList _far[SLOTS]; // 256 ticks each
+
+            std::multimap<uint64_t, Key> _overflow;
+
+            KeyList _late; // Due on the next advance
+
+            uint64_t _now;
+
+            unsigned int _size;
+
+            std::mutex _mutex;
+
+            /** Files a timer relative to _now, caller holds the lock */
+            void insert(Key chunk, uint64_t tick);
+    };
+}
+
+#endif //UPDATEWHEEL_INCLUDED
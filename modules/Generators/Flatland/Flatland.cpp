@@ -50,17 +50,19 @@ namespace EJV
 		 */
 		Chunk *generateChunk(int chunkX, int chunkY, int chunkZ)
 		{
-			Chunk* newChunk = new Chunk;
-
 			unsigned short newBlock = chunkY ? BLOCK_TYPE : 0;
 
+			// Uniform chunks share one instance per block type
+			if (!newBlock || !HEIGHT) return Chunk::getShared(0);
+
+			if (HEIGHT >= CHUNK_HEIGHT) return Chunk::getShared(newBlock);
+
+			Chunk* newChunk = new Chunk(0);
+
 			for (unsigned short x = 0; x < CHUNK_WIDTH; ++x)
-				for (unsigned short z = 0; z < CHUNK_HEIGHT; ++z)
-					for (unsigned short y = 0; y < CHUNK_LENGTH; ++y)
-						if (y < 4)
-							newChunk->blocks[x][z][y] = newBlock;
-						else
-							newChunk->blocks[x][z][y] = 0;
+				for (unsigned short z = 0; z < CHUNK_LENGTH; ++z)
+					for (unsigned short y = 0; y < HEIGHT; ++y)
+						newChunk->setBlock(x, y, z, newBlock);
 
 			return newChunk;
 		}
@@ -42,9 +42,7 @@ namespace EJV
 		 */
 		extern "C" Chunk *generateChunk(int x, int y, int z)
 		{
-			Chunk* newChunk = new Chunk;
-
-			return newChunk;
+			return Chunk::getShared(0);
 		}
 	}
 }
@@ -4,8 +4,8 @@
  * Copyright (c) Empty Juice Box Group :: All Rights Reserved       *
  *#****************************************************************#*/
 
-#ifndef LOADER_INCLUDED
-#define LOADER_INCLUDED
+#ifndef ANVILLOADER_INCLUDED
+#define ANVILLOADER_INCLUDED
 
 #include <string>
 #include <map>
@@ -25,11 +25,148 @@
 
 struct RegionData {
 	mNBT::RegionLoader* loader;
-	short count; //Used to know when to empty a regionLoader.
+	unsigned int count; //loadChunk calls not released yet, used to know when to empty a regionLoader.
 };
 
 std::map<std::pair<int,int>,RegionData*> loadMap;
 
+/**
+ * Gets the region of a chunk, opening it if needed.
+ * Newly opened regions start with a count of 0.
+ *
+ * @param x X chunk coord.
+ * @param z Z chunk coord.
+ * @return The region's data.
+ */
+static RegionData *openRegion(int x, int z) {
+	RegionData*& region = loadMap[std::pair<int,int>(x >> 5, z >> 5)];
+	if (region == NULL) {
+		region = new RegionData;
+		region->count = 0;
+		region->loader = new mNBT::RegionLoader("world", x >> 5, z >> 5);
+	}
+	return region;
+}
+
+/**
+ * Saves and closes a region no chunk of is loaded.
+ *
+ * @param x X chunk coord.
+ * @param z Z chunk coord.
+ */
+static void closeRegion(int x, int z) {
+	std::map<std::pair<int,int>,RegionData*>::iterator it = loadMap.find(std::pair<int,int>(x >> 5, z >> 5));
+	if (it == loadMap.end() || it->second->count > 0)
+		return;
+	it->second->loader->save();
+	delete it->second->loader;
+	delete it->second;
+	loadMap.erase(it);
+}
+
+/**
+ * Finds one section of an anvil chunk column.
+ *
+ * @param column NBT structure of the chunk column.
+ * @param y Y chunk coord (section index).
+ * @return The section, NULL if it doesn't exist.
+ */
+static mNBT::Tag *findSection(mNBT::Tag* column, int y) {
+	mNBT::List* sections = mNBT::NBTC<mNBT::List>(column->getTag("Level.Sections"));
+
+	for (std::list<mNBT::Tag*>::iterator it = sections->begin(); it != sections->end(); ++it) {
+		if (mNBT::NBTC<mNBT::Byte>((*it)->getTag("Y"))->getPayload() == y)
+			return *it;
+	}
+
+	return NULL;
+}
+
+/**
+ * Copies one section of an anvil chunk column into a chunk.
+ * Anvil sections store their block IDs as YZX ordered bytes, the
+ * scheduled updates are kept in "EJVUpdates" as (index, priority,
+ * low tick, high tick) quadruples, absolute world ticks.
+ *
+ * @param column NBT structure of the chunk column.
+ * @param y Y chunk coord (section index).
+ * @return A new chunk, NULL if the section doesn't exist.
+ */
+static EJV::Chunk *sectionToChunk(mNBT::Tag* column, int y) {
+	mNBT::Tag* section = findSection(column, y);
+
+	if (section == NULL)
+		return NULL;
+
+	mNBT::ByteArray& blocks = *mNBT::NBTC<mNBT::ByteArray>(section->getTag("Blocks"));
+
+	EJV::Chunk* newChunk = new EJV::Chunk((unsigned char) blocks[0]);
+
+	for (unsigned int i = 0; i < CHUNK_VOLUME; ++i)
+		newChunk->setBlock(i & 15, i >> 8, (i >> 4) & 15, (unsigned char) blocks[i]);
+
+	std::map<std::string,mNBT::Tag*>* tags = mNBT::NBTC<mNBT::Compound>(section)->getPayload();
+	std::map<std::string,mNBT::Tag*>::iterator updates = tags->find("EJVUpdates");
+
+	if (updates != tags->end()) {
+		std::vector<int>& data = *mNBT::NBTC<mNBT::IntArray>(updates->second)->getPayload();
+
+		for (size_t i = 0; i + 3 < data.size(); i += 4)
+			newChunk->editScheduledUpdates().schedule(data[i], (uint64_t) (uint32_t) data[i + 2] | (uint64_t) (uint32_t) data[i + 3] << 32, data[i + 1]);
+	}
+
+	if (!newChunk->isUniform() || !newChunk->getScheduledUpdates().empty())
+		return newChunk;
+
+	// Sections of a single block type share one instance
+	EJV::Chunk* shared = EJV::Chunk::getShared(newChunk->getBlockAt(0));
+	delete newChunk;
+	return shared;
+}
+
+/**
+ * Copies a chunk into one section of an anvil chunk column,
+ * adding the section if it doesn't exist yet.
+ * Only the low byte of block IDs is stored (no "Add" array).
+ *
+ * @param column NBT structure of the chunk column.
+ * @param y Y chunk coord (section index).
+ * @param c Chunk to copy.
+ */
+static void chunkToSection(mNBT::Tag* column, int y, const EJV::Chunk* c) {
+	mNBT::Tag* section = findSection(column, y);
+
+	if (section == NULL) {
+		section = new mNBT::Compound;
+		mNBT::Compound* compound = mNBT::NBTC<mNBT::Compound>(section);
+		compound->add(new mNBT::Byte("Y", (char) y));
+		compound->add(new mNBT::ByteArray("Blocks", std::vector<char>(CHUNK_VOLUME)));
+		compound->add(new mNBT::ByteArray("Data", std::vector<char>(CHUNK_VOLUME / 2)));
+		compound->add(new mNBT::ByteArray("BlockLight", std::vector<char>(CHUNK_VOLUME / 2)));
+		compound->add(new mNBT::ByteArray("SkyLight", std::vector<char>(CHUNK_VOLUME / 2, (char) 0xFF)));
+		mNBT::NBTC<mNBT::List>(column->getTag("Level.Sections"))->add(section);
+	}
+
+	std::vector<char>& blocks = *mNBT::NBTC<mNBT::ByteArray>(section->getTag("Blocks"))->getPayload();
+
+	for (unsigned int i = 0; i < CHUNK_VOLUME; ++i)
+		blocks[i] = (char) c->getBlock(i & 15, i >> 8, (i >> 4) & 15);
+
+	const EJV::ScheduledUpdates& updates = c->getScheduledUpdates();
+	std::vector<int> data;
+	data.reserve(updates.size() * 4);
+
+	for (EJV::ScheduledUpdates::const_iterator it = updates.begin(); it != updates.end(); ++it) {
+		data.push_back(it->index);
+		data.push_back(it->priority);
+		data.push_back((int) (uint32_t) it->tick);
+		data.push_back((int) (uint32_t) (it->tick >> 32));
+	}
+
+	// Replaces the previous list, an empty one drops it
+	mNBT::NBTC<mNBT::Compound>(section)->add(new mNBT::IntArray("EJVUpdates", data));
+}
+
 extern "C"
 {
 	/**
@@ -44,9 +181,9 @@ extern "C"
 	 */
 	void destroy() {
 		for (auto& it: loadMap) {
-			it->second->loader->save();
-			delete it->second->loader;
-			delete it->second;
+			it.second->loader->save();
+			delete it.second->loader;
+			delete it.second;
 		}
 		loadMap.clear();
 		return;
@@ -56,42 +193,56 @@ extern "C"
 	 * Get a chunk from disc.
 	 */
 	EJV::Chunk *loadChunk(int x, int y, int z) {
-		mNBT::Tag* chunk;
-		std::pair <int,int> coords(x >> 5, z >> 5);
-		if (loadMap.count(coords)) {
-			chunk = loadMap[coords]->loader->getChunk(x % 32, z % 32);
-		} else {
-		mNBT::RegionLoader* newRegion = new mNBT::RegionLoader("world",x>>5,z>>5);
-		RegionData* newLoader = new RegionData;
-		newLoader->count = 1;
-		newLoader->loader = newRegion;
-		loadMap[coords] = newLoader;
-		chunk = newRegion->getChunk(x,z);
-		}
-		if (chunk == NULL)
+		RegionData* region = openRegion(x, z);
+		++region->count;
+
+		mNBT::Tag* column = region->loader->getChunk(x & 31, z & 31);
+		if (column == NULL)
 			return NULL;
-		
+
+		EJV::Chunk* chunk = sectionToChunk(column, y);
+		delete column;
+		return chunk;
 	}
 
 	/**
-	 * Saves a chunk to the disc.
+	 * Saves a chunk to the disc, with its scheduled updates.
+	 * Opens the region if no chunk of it is loaded.
 	 *
 	 * @param x X chunk coord.
 	 * @param y Y chunk coord.
 	 * @param z Z chunk coord.
-	 * @param c Chunk to save.B
+	 * @param c Chunk to save.
 	 */
-	void putChunk(int x, int y, int z, EJV::Chunk *c);
+	void putChunk(int x, int y, int z, EJV::Chunk *c) {
+		RegionData* region = openRegion(x, z);
+
+		mNBT::Tag* column = region->loader->getChunk(x & 31, z & 31);
+		if (column != NULL) {
+			chunkToSection(column, y, c);
+			region->loader->putChunk(column, x & 31, z & 31);
+			delete column;
+		}
+
+		closeRegion(x, z);
+	}
 
 	/**
 	 * Releases a chunk.
+	 * Saves and closes its region once no chunk of it is loaded.
 	 *
 	 * @param x X chunk coord.
 	 * @param y Y chunk coord.
 	 * @param z Z chunk coord.
 	 * @param c Chunk to release.
 	 */
-	void releaseChunk(int x, int y, int z, EJV::Chunk *c);
+	void releaseChunk(int x, int y, int z, EJV::Chunk *c) {
+		std::map<std::pair<int,int>,RegionData*>::iterator it = loadMap.find(std::pair<int,int>(x >> 5, z >> 5));
+		if (it == loadMap.end())
+			return;
+		--it->second->count;
+		closeRegion(x, z);
+	}
 
 	/**
 	 * Get metadata about the world.
@@ -122,4 +273,4 @@ extern "C"
  */
 void invalidateChunk(int x, int y, int z);
 
-#endif //LOADER_INCLUDED
+#endif //ANVILLOADER_INCLUDED
@@ -6,19 +6,25 @@ namespace StandardBlocks
 {
     void init()
     {
-        BlockInfo* air         = new BlockInfo;
-        BlockInfo* stone       = new BlockInfo;
-        BlockInfo* grass       = new BlockInfo;
-        BlockInfo* dirt        = new BlockInfo;
-        BlockInfo* cobblestone = new BlockInfo;
+        BlockInfo air;
+        BlockInfo stone;
+        BlockInfo grass;
+        BlockInfo dirt;
+        BlockInfo cobblestone;
+
+        air.solid = false;
+        air.opaque = false;
+        air.replaceable = true;
+
+        grass.randomTicks = true;
 
         State& core = State::GET();
 
-        BLOCK_AIR         = core.registerData(air);
-        BLOCK_STONE       = core.registerData(stone);
-        BLOCK_GRASS       = core.registerData(grass);
-        BLOCK_DIRT        = core.registerData(dirt);
-        BLOCK_COBBLESTONE = core.registerData(cobblestone);
+        BLOCK_AIR         = core.registerBlock(air);
+        BLOCK_STONE       = core.registerBlock(stone);
+        BLOCK_GRASS       = core.registerBlock(grass);
+        BLOCK_DIRT        = core.registerBlock(dirt);
+        BLOCK_COBBLESTONE = core.registerBlock(cobblestone);
 
         std::cout << "Loaded StandardBlocks" << std::endl;
     }
@@ -158,7 +158,8 @@ namespace StandardBlocks
 
         void destroy() {}
 
-        void tick(Action::Base* event) {}
+        // Reacts to no actions, never ticked
+        ActionMask getActionMask() { return 0; }
     }
 }
 
@@ -6,6 +6,10 @@ namespace StandardEntities
     {
         EntityInfo player;
 
+        // Chunks around players load and tick, random ticks included
+        player.ticketRadius = 4;
+        player.ticketType = TICKET_PLAYER;
+
         State& core = State::GET();
 
         ENTITY_PLAYER = core.registerEntity(player);
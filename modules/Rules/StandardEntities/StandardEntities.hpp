@@ -15,7 +15,8 @@ namespace StandardEntities
 
         void destroy() {}
 
-        void tick(Action::Base* event) {}
+        // Reacts to no actions, never ticked
+        ActionMask getActionMask() { return 0; }
     }
 }
 
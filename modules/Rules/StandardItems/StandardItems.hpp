@@ -19,7 +19,8 @@ namespace StandardItems
 
         void destroy() {}
 
-        void tick(Action::Base* event) {}
+        // Reacts to no actions, never ticked
+        ActionMask getActionMask() { return 0; }
     }
 }
 
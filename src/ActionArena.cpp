@@ -0,0 +1,179 @@
+#include "ActionArena.hpp"
+
+#include <cstring>
+#include <thread>
+
+namespace EJV
+{
+    namespace
+    {
+        // Enough for any action
+        const size_t ALIGNMENT = 16;
+
+        // Spare blocks kept beyond this go back to the system
+        const size_t MAX_SPARE = 64;
+
+        inline size_t alignSize(size_t size)
+        {
+            return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+    }
+
+    ActionArena::ActionArena() : _filling(0), _allocations(0), _bytes(0), _blocks(0), _large(0)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            _halves[i].current.store(takeBlock(), std::memory_order_relaxed);
+            _halves[i].writers.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ActionArena::~ActionArena()
+    {
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            Half& half = _halves[i];
+
+            delete half.current.load(std::memory_order_relaxed);
+
+            for (std::vector<Block*>::iterator it = half.full.begin(); it != half.full.end(); ++it) delete *it;
+            for (std::vector<char*>::iterator it = half.large.begin(); it != half.large.end(); ++it) delete[] *it;
+        }
+
+        for (std::vector<Block*>::iterator it = _spare.begin(); it != _spare.end(); ++it) delete *it;
+    }
+
+    ActionArena::Half* ActionArena::pin()
+    {
+        for (;;)
+        {
+            const unsigned int index = _filling.load();
+
+            Half& half = _halves[index];
+
+            half.writers.fetch_add(1);
+
+            // Flipped before the pin showed, the tick may already be releasing it
+            if (_filling.load() == index) return &half;
+
+            half.writers.fetch_sub(1);
+        }
+    }
+
+    void ActionArena::unpin(Half* half)
+    {
+        half->writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void ActionArena::flip()
+    {
+        const unsigned int old = _filling.load();
+
+        _filling.store(1 - old);
+
+        // Writers only hold on for an allocation and a push
+        while (_halves[old].writers.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    void ActionArena::release()
+    {
+        Half& half = _halves[1 - _filling.load()];
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (std::vector<Block*>::iterator it = half.full.begin(); it != half.full.end(); ++it)
+        {
+            if (_spare.size() < MAX_SPARE) _spare.push_back(*it);
+            else delete *it;
+        }
+
+        for (std::vector<char*>::iterator it = half.large.begin(); it != half.large.end(); ++it) delete[] *it;
+
+        half.full.clear();
+        half.large.clear();
+
+        half.current.load(std::memory_order_relaxed)->used.store(0, std::memory_order_relaxed);
+    }
+
+    void* ActionArena::allocate(Half& half, size_t size)
+    {
+        size = alignSize(size ? size : 1);
+
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        _bytes.fetch_add(size, std::memory_order_relaxed);
+
+        // Would waste most of a block
+        if (size > BLOCK_SIZE / 4)
+        {
+            char* memory = new char[size];
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            half.large.push_back(memory);
+
+            _large.fetch_add(1, std::memory_order_relaxed);
+
+            return memory;
+        }
+
+        for (;;)
+        {
+            Block* block = half.current.load(std::memory_order_acquire);
+
+            const size_t offset = block->used.fetch_add(size, std::memory_order_relaxed);
+
+            if (offset + size <= BLOCK_SIZE) return block->data + offset;
+
+            // Full, the first writer to get here under the lock starts a new block
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (half.current.load(std::memory_order_relaxed) == block)
+            {
+                half.full.push_back(block);
+
+                half.current.store(takeBlock(), std::memory_order_release);
+            }
+        }
+    }
+
+    ActionArena::Block* ActionArena::takeBlock()
+    {
+        Block* block;
+
+        if (!_spare.empty())
+        {
+            block = _spare.back();
+
+            _spare.pop_back();
+        }
+        else
+        {
+            block = new Block;
+
+            _blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        block->used.store(0, std::memory_order_relaxed);
+
+        return block;
+    }
+
+    const char* ActionArena::Writer::copy(const std::string& text)
+    {
+        char* memory = (char*) allocate(text.size() + 1);
+
+        std::memcpy(memory, text.c_str(), text.size() + 1);
+
+        return memory;
+    }
+
+    ActionArena::Stats ActionArena::getStats() const
+    {
+        Stats stats = { _allocations.load(std::memory_order_relaxed), _bytes.load(std::memory_order_relaxed),
+                        _blocks.load(std::memory_order_relaxed), _large.load(std::memory_order_relaxed) };
+
+        return stats;
+    }
+}
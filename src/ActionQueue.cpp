@@ -0,0 +1,104 @@
+#include "ActionQueue.hpp"
+
+#include <thread>
+
+namespace EJV
+{
+    namespace
+    {
+        uint64_t roundCapacity(unsigned int capacity)
+        {
+            uint64_t rounded = 2;
+
+            while (rounded < capacity) rounded *= 2;
+
+            return rounded;
+        }
+    }
+
+    ActionQueue::ActionQueue(unsigned int capacity) : _slots(new Slot[roundCapacity(capacity)]), _mask(roundCapacity(capacity) - 1),
+                                                      _tail(0), _pushed(0), _rejected(0), _head(0), _drained(0)
+    {
+        for (uint64_t i = 0; i <= _mask; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+            _slots[i].action = 0;
+        }
+    }
+
+    bool ActionQueue::push(Action::Base* action)
+    {
+        uint64_t position = _tail.load(std::memory_order_relaxed);
+
+        Slot* slot;
+
+        for (;;)
+        {
+            slot = &_slots[position & _mask];
+
+            const int64_t difference = (int64_t) (slot->sequence.load(std::memory_order_acquire) - position);
+
+            if (!difference)
+            {
+                // Free for this position, claim it
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0)
+            {
+                // Still holds the action from one lap ago
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+
+                return false;
+            }
+            else
+            {
+                // Claimed by another producer meanwhile
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->action = action;
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        _pushed.fetch_add(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    unsigned int ActionQueue::drain(ActionList& actions)
+    {
+        const uint64_t end = _tail.load(std::memory_order_acquire);
+
+        uint64_t head = _head.load(std::memory_order_relaxed);
+
+        const uint64_t start = head;
+
+        while (head != end)
+        {
+            Slot& slot = _slots[head & _mask];
+
+            // Claimed but not filled yet, the producer is a couple of stores away from it
+            while (slot.sequence.load(std::memory_order_acquire) != head + 1) std::this_thread::yield();
+
+            actions.push_back(slot.action);
+
+            slot.sequence.store(head + _mask + 1, std::memory_order_release);
+
+            ++head;
+        }
+
+        _head.store(head, std::memory_order_release);
+
+        _drained.fetch_add(head - start, std::memory_order_relaxed);
+
+        return head - start;
+    }
+
+    ActionQueue::Stats ActionQueue::getStats() const
+    {
+        Stats stats = { _pushed.load(std::memory_order_relaxed), _rejected.load(std::memory_order_relaxed),
+                        _drained.load(std::memory_order_relaxed) };
+
+        return stats;
+    }
+}
@@ -0,0 +1,240 @@
+#include "AutoSaver.hpp"
+#include "GlobalState.hpp"
+
+#include <chrono>
+
+namespace EJV
+{
+    AutoSaver::~AutoSaver()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _stop = true;
+        }
+
+        _wake.notify_all();
+
+        if (_writer.joinable()) _writer.join();
+    }
+
+    void AutoSaver::update(uint64_t tick)
+    {
+        std::vector<Written> written;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            written.swap(_written);
+        }
+
+        // Mark the chunks written since the last tick as saved
+        for (std::vector<Written>::const_iterator it = written.begin(); it != written.end(); ++it)
+        {
+            ChunkIndex::Entry* entry = _world->loadedChunks.lookup(it->point);
+
+            if (entry && entry->chunk->getSerial() == it->serial) entry->chunk->markSaved(it->count);
+        }
+
+        if (!_interval) return;
+
+        // Start a new cycle
+        if (_remaining.empty())
+        {
+            if (tick < _cycleStart + _interval) return;
+
+            _cycleStart = tick;
+
+            for (ChunkIndex::const_iterator it = _world->loadedChunks.begin(); it != _world->loadedChunks.end(); ++it)
+            {
+                if (it->chunk->isDirty()) _remaining.push_back(it->getPoint());
+            }
+
+            if (_remaining.empty()) return;
+
+            if (!_writer.joinable()) _writer = std::thread(&AutoSaver::write, this);
+        }
+
+        // Copy chunks until the tick's budget is spent
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(_budget);
+
+        do
+        {
+            Point3D point = _remaining.back();
+
+            _remaining.pop_back();
+
+            Chunk* chunk = _world->loadedChunks.find(point);
+
+            if (!chunk || !chunk->isDirty()) continue;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                SnapshotMap::const_iterator it = _latest.find(ChunkIndex::key(point));
+
+                // Still queued from the last cycle and unchanged since
+                if (it != _latest.end() && it->second->serial == chunk->getSerial() && it->second->count == chunk->getModificationCount()) continue;
+            }
+
+            Snapshot* snapshot = new Snapshot;
+
+            snapshot->point = point;
+            snapshot->serial = chunk->getSerial();
+            snapshot->copy = new Chunk(*chunk);
+            snapshot->count = chunk->getModificationCount();
+            snapshot->cancelled = false;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                Snapshot*& latest = _latest[ChunkIndex::key(point)];
+
+                // An older copy still in the queue is outdated
+                if (latest) latest->cancelled = true;
+
+                latest = snapshot;
+
+                _queue.push_back(snapshot);
+
+                ++_snapshotCount;
+            }
+
+            _wake.notify_one();
+        }
+        while (!_remaining.empty() && std::chrono::steady_clock::now() < deadline);
+    }
+
+    void AutoSaver::cancel(const Point3D& point)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Written but not marked yet, the chunk may be gone by then
+        for (std::vector<Written>::iterator it = _written.begin(); it != _written.end(); )
+        {
+            if (it->point == point) it = _written.erase(it);
+            else ++it;
+        }
+
+        SnapshotMap::iterator it = _latest.find(ChunkIndex::key(point));
+
+        if (it == _latest.end()) return;
+
+        it->second->cancelled = true;
+
+        _latest.erase(it);
+    }
+
+    void AutoSaver::flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (!_queue.empty() || _busy) _idle.wait(lock);
+    }
+
+    AutoSaver::Stats AutoSaver::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        Stats stats;
+
+        stats.snapshots = _snapshotCount;
+        stats.written = _writtenCount;
+        stats.cancelled = _cancelledCount;
+        stats.failed = _failedCount;
+
+        stats.remaining = _remaining.size();
+        stats.backlog = _queue.size();
+
+        stats.writeRate = _busySeconds > 0 ? _writtenCount / _busySeconds : 0;
+
+        return stats;
+    }
+
+    void AutoSaver::write()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (true)
+        {
+            while (_queue.empty() && !_stop) _wake.wait(lock);
+
+            // Queued copies are still written when stopping
+            if (_queue.empty()) return;
+
+            Snapshot* snapshot = _queue.front();
+
+            _queue.pop_front();
+
+            _busy = true;
+
+            lock.unlock();
+
+            enum { WRITTEN, CANCELLED, FAILED } result = CANCELLED;
+
+            double seconds = 0;
+
+            {
+                std::lock_guard<std::mutex> loaderLock(_world->loader->mutex);
+
+                bool cancelled;
+
+                // Checked under the loader lock, synchronous saves cancel before taking it
+                {
+                    std::lock_guard<std::mutex> check(_mutex);
+
+                    cancelled = snapshot->cancelled;
+                }
+
+                if (!cancelled)
+                {
+                    TickProfiler::Scope scope(State::GET().profiler, _world->phases.save);
+
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                    try
+                    {
+                        Tracer::Scope trace("putChunk", snapshot->point);
+
+                        _world->loader->putChunk(snapshot->point.x, snapshot->point.y, snapshot->point.z, snapshot->copy);
+
+                        result = WRITTEN;
+                    }
+                    catch (...)
+                    {
+                        result = FAILED;
+                    }
+
+                    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                }
+            }
+
+            delete snapshot->copy;
+
+            lock.lock();
+
+            SnapshotMap::iterator it = _latest.find(ChunkIndex::key(snapshot->point));
+
+            if (it != _latest.end() && it->second == snapshot) _latest.erase(it);
+
+            _busySeconds += seconds;
+
+            if (result == WRITTEN)
+            {
+                Written written = { snapshot->point, snapshot->serial, snapshot->count };
+
+                _written.push_back(written);
+
+                ++_writtenCount;
+            }
+            else if (result == FAILED) ++_failedCount;
+            else ++_cancelledCount;
+
+            delete snapshot;
+
+            _busy = false;
+
+            if (_queue.empty()) _idle.notify_all();
+        }
+    }
+}
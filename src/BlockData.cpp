@@ -0,0 +1,104 @@
+#include "BlockData.hpp"
+
+namespace EJV
+{
+    const BlockDataTable::Entry* BlockDataTable::find(unsigned int index) const
+    {
+        if (!_size) return 0;
+
+        for (unsigned int i = slot(index); ; i = (i + 1) & (_entries.size() - 1))
+        {
+            const Entry& entry = _entries[i];
+
+            if (entry.index == index) return &entry;
+
+            if (entry.index == EMPTY) return 0;
+        }
+    }
+
+    void BlockDataTable::insert(unsigned int index, Type type, uint64_t value)
+    {
+        // Keep the load factor at or below one half
+        if ((_size + 1) * 2 > _entries.size()) rehash(_entries.empty() ? 8 : _entries.size() * 2);
+
+        unsigned int i = slot(index);
+
+        while (_entries[i].index != EMPTY && _entries[i].index != index) i = (i + 1) & (_entries.size() - 1);
+
+        Entry& entry = _entries[i];
+
+        if (entry.index == EMPTY) ++_size;
+
+        ++_modCount;
+
+        entry.index = index;
+        entry.type = type;
+        entry.value = value;
+    }
+
+    bool BlockDataTable::erase(unsigned int index)
+    {
+        const Entry* found = find(index);
+
+        if (!found) return false;
+
+        const unsigned int mask = _entries.size() - 1;
+
+        unsigned int hole = found - _entries.data();
+
+        // Backward shift deletion, leaves no tombstones behind
+        for (unsigned int i = (hole + 1) & mask; _entries[i].index != EMPTY; i = (i + 1) & mask)
+        {
+            unsigned int home = slot(_entries[i].index);
+
+            // Move the entry if its home slot isn't within (hole, i]
+            if (((i - home) & mask) >= ((i - hole) & mask))
+            {
+                _entries[hole] = _entries[i];
+
+                hole = i;
+            }
+        }
+
+        _entries[hole].index = EMPTY;
+
+        --_size;
+
+        ++_modCount;
+
+        return true;
+    }
+
+    void BlockDataTable::clear()
+    {
+        EntryList().swap(_entries);
+
+        _size = 0;
+
+        ++_modCount;
+    }
+
+    void BlockDataTable::rehash(unsigned int capacity)
+    {
+        Entry empty;
+
+        empty.index = EMPTY;
+        empty.type = 0;
+        empty.value = 0;
+
+        EntryList entries(capacity, empty);
+
+        entries.swap(_entries);
+
+        for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->index == EMPTY) continue;
+
+            unsigned int i = slot(it->index);
+
+            while (_entries[i].index != EMPTY) i = (i + 1) & (capacity - 1);
+
+            _entries[i] = *it;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "BlockProperties.hpp"
+
+namespace EJV
+{
+    void BlockProperties::set(Chunk::BlockID id, bool solid, bool opaque, bool tickable, bool replaceable, unsigned char light)
+    {
+        if (id >= _light.size())
+        {
+            _light.resize(id + 1, 0);
+
+            for (unsigned int i = 0; i < PROPERTY_COUNT; ++i) _bits[i].resize(id / 64 + 1, 0);
+        }
+
+        const bool values[PROPERTY_COUNT] = { solid, opaque, tickable, replaceable, light > 0 };
+
+        for (unsigned int i = 0; i < PROPERTY_COUNT; ++i)
+        {
+            uint64_t bit = uint64_t(1) << (id % 64);
+
+            _bits[i][id / 64] = values[i] ? _bits[i][id / 64] | bit : _bits[i][id / 64] & ~bit;
+        }
+
+        _light[id] = light;
+    }
+
+    ColumnQuery::ColumnQuery(const BlockProperties& properties, const Chunk& chunk, BlockProperties::Property property)
+        : _data(chunk.getIndexWords()), _bits(chunk.getBitsPerBlock()), _uniform(0)
+    {
+        const unsigned int size = chunk.getPaletteSize();
+
+        if (!_bits) _uniform = properties.has(chunk.getPaletteEntry(0), property) ? 0xFFFF : 0;
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            _valueMask[i] = i < size && properties.has(chunk.getPaletteEntry(i), property) ? 0xFFFF : 0;
+        }
+
+#ifdef __SSSE3__
+        alignas(16) unsigned char bytes[16];
+
+        for (unsigned int i = 0; i < 16; ++i) bytes[i] = _valueMask[i] ? 0x80 : 0;
+
+        _shuffle = _mm_load_si128((const __m128i*) bytes);
+#endif
+
+        if (_bits > 4)
+        {
+            _table.resize(size);
+
+            for (unsigned int i = 0; i < size; ++i) _table[i] = properties.has(chunk.getPaletteEntry(i), property);
+        }
+    }
+
+    uint16_t ColumnQuery::matchTable(unsigned int first) const
+    {
+        const unsigned int perWord = 64 / _bits;
+        const uint64_t mask = (uint64_t(1) << _bits) - 1;
+
+        uint16_t match = 0;
+
+        for (unsigned int y = 0; y < CHUNK_HEIGHT; ++y)
+        {
+            const unsigned int i = first + y;
+
+            match |= uint16_t(_table[(_data[i / perWord] >> (i % perWord * _bits)) & mask]) << y;
+        }
+
+        return match;
+    }
+}
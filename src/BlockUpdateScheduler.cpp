@@ -0,0 +1,154 @@
+#include "BlockUpdateScheduler.hpp"
+
+#include "GlobalState.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace EJV
+{
+    namespace
+    {
+        struct Item
+        {
+            unsigned int colour;
+
+            ChunkIndex::Key region;
+            ChunkIndex::Key chunk;
+
+            unsigned int order;
+
+            bool operator<(const Item& i) const
+            {
+                if (colour != i.colour) return colour < i.colour;
+                if (region != i.region) return region < i.region;
+                if (chunk != i.chunk)   return chunk < i.chunk;
+
+                return order < i.order;
+            }
+        };
+
+        inline int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+    }
+
+    void BlockUpdateScheduler::partition(const BlockList& blocks)
+    {
+        std::vector<Item> items(blocks.size());
+
+        for (unsigned int i = 0; i < blocks.size(); ++i)
+        {
+            Point3D chunk, local;
+
+            splitBlockPosition(blocks[i], chunk, local);
+
+            Point3D region(floorDiv(chunk.x, _regionSize), floorDiv(chunk.y, _regionSize), floorDiv(chunk.z, _regionSize));
+
+            items[i].colour = (region.x & 1) | (region.y & 1) << 1 | (region.z & 1) << 2;
+            items[i].region = ChunkIndex::key(region);
+            items[i].chunk = ChunkIndex::key(chunk);
+            items[i].order = i;
+        }
+
+        std::sort(items.begin(), items.end());
+
+        _blocks.clear();
+        _chunks.clear();
+        _regions.clear();
+
+        _blocks.reserve(items.size());
+
+        unsigned int colour = 0;
+
+        _colours[0] = 0;
+
+        for (unsigned int i = 0; i < items.size(); ++i)
+        {
+            const Item& item = items[i];
+
+            bool newRegion = !i || item.region != items[i - 1].region || item.colour != items[i - 1].colour;
+
+            if (newRegion)
+            {
+                if (!_regions.empty()) _regions.back().end = i;
+
+                while (colour < item.colour) _colours[++colour] = _regions.size();
+
+                Range range = { i, i };
+
+                _regions.push_back(range);
+            }
+
+            if (newRegion || item.chunk != items[i - 1].chunk) _chunks.push_back(item.chunk);
+
+            _blocks.push_back(blocks[item.order]);
+        }
+
+        if (!_regions.empty()) _regions.back().end = items.size();
+
+        while (colour < COLOURS) _colours[++colour] = _regions.size();
+
+        std::sort(_chunks.begin(), _chunks.end());
+
+        _stats = Stats();
+
+        _stats.updates = _blocks.size();
+        _stats.chunks = _chunks.size();
+        _stats.regions = _regions.size();
+    }
+
+    void BlockUpdateScheduler::getReachedChunks(std::vector<Point3D>& chunks) const
+    {
+        const int reach = getReach();
+
+        std::set<ChunkIndex::Key> reached;
+
+        for (std::vector<ChunkIndex::Key>::const_iterator it = _chunks.begin(); it != _chunks.end(); ++it)
+        {
+            Point3D center = ChunkIndex::point(*it);
+
+            for (int x = -reach; x <= reach; ++x)
+            for (int y = -reach; y <= reach; ++y)
+            for (int z = -reach; z <= reach; ++z)
+            {
+                Point3D point(center.x + x, center.y + y, center.z + z);
+
+                if (reached.insert(ChunkIndex::key(point)).second) chunks.push_back(point);
+            }
+        }
+    }
+
+    void BlockUpdateScheduler::run(ThreadPool& pool, const UpdateFunction& update)
+    {
+        _stats.parallel = isParallelPass();
+
+        for (unsigned int colour = 0; colour < COLOURS; ++colour)
+        {
+            const unsigned int first = _colours[colour];
+            const unsigned int count = _colours[colour + 1] - first;
+
+            if (_stats.parallel && count > 1)
+            {
+                // Each colour waits for the previous one, regions of a colour never meet
+                pool.parallelFor(count, [this, first, &update](unsigned int i) { runRegion(first + i, update); });
+            }
+            else
+            {
+                for (unsigned int i = 0; i < count; ++i) runRegion(first + i, update);
+            }
+        }
+
+        _blocks.clear();
+        _chunks.clear();
+        _regions.clear();
+    }
+
+    void BlockUpdateScheduler::runRegion(unsigned int region, const UpdateFunction& update) const
+    {
+        const Range& range = _regions[region];
+
+        for (unsigned int i = range.begin; i < range.end; ++i)
+        {
+            update(_blocks[i]);
+        }
+    }
+}
@@ -0,0 +1,192 @@
+#include "Chunk.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace EJV
+{
+    namespace
+    {
+        inline unsigned int readEntry(const Chunk::IndexList& data, unsigned char bits, unsigned int i)
+        {
+            const unsigned int perWord = 64 / bits;
+
+            return (data[i / perWord] >> ((i % perWord) * bits)) & ((uint64_t(1) << bits) - 1);
+        }
+
+        inline void writeEntry(Chunk::IndexList& data, unsigned char bits, unsigned int i, uint64_t entry)
+        {
+            const unsigned int perWord = 64 / bits;
+            const unsigned int shift = (i % perWord) * bits;
+            const uint64_t mask = ((uint64_t(1) << bits) - 1) << shift;
+
+            uint64_t& word = data[i / perWord];
+
+            word = (word & ~mask) | (entry << shift);
+        }
+
+        /** Smallest supported entry width able to address a palette */
+        inline unsigned char bitsForPalette(size_t size)
+        {
+            unsigned char bits = 1;
+
+            while ((size_t(1) << bits) < size) bits *= 2;
+
+            return bits;
+        }
+    }
+
+    Chunk& Chunk::operator=(const Chunk& orig)
+    {
+        checkWritable();
+
+        _blockData = orig._blockData;
+        _scheduledUpdates = orig._scheduledUpdates;
+
+        _palette = orig._palette;
+        _data = orig._data;
+
+        _uniform = orig._uniform;
+        _bits = orig._bits;
+
+        ++_modCount;
+
+        return *this;
+    }
+
+    Chunk* Chunk::getShared(BlockID id)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<BlockID, Chunk*> shared;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        Chunk*& chunk = shared[id];
+
+        if (!chunk)
+        {
+            chunk = new Chunk(id);
+
+            chunk->_shared = true;
+        }
+
+        return chunk;
+    }
+
+    uint64_t Chunk::nextSerial()
+    {
+        static std::atomic<uint64_t> serial(0);
+
+        return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    void Chunk::checkWritable() const
+    {
+        if (_shared) throw std::runtime_error("Write to a shared chunk");
+    }
+
+    void Chunk::setBlockAt(unsigned int i, BlockID id)
+    {
+        checkWritable();
+
+        if (getBlockAt(i) == id) return;
+
+        ++_modCount;
+
+        if (!_bits)
+        {
+            // Leave the uniform fast path, every index points to entry 0
+            _palette.assign(1, _uniform);
+
+            repack(1);
+        }
+
+        unsigned int entry = std::find(_palette.begin(), _palette.end(), id) - _palette.begin();
+
+        if (entry == _palette.size())
+        {
+            _palette.push_back(id);
+
+            if (entry >> _bits) repack(_bits * 2);
+        }
+
+        writeEntry(_data, _bits, i, entry);
+    }
+
+    void Chunk::fill(BlockID id)
+    {
+        checkWritable();
+
+        ++_modCount;
+
+        Palette().swap(_palette);
+        IndexList().swap(_data);
+
+        _uniform = id;
+        _bits = 0;
+    }
+
+    void Chunk::compact()
+    {
+        if (!_bits) return;
+
+        const unsigned int UNUSED = ~0u;
+
+        std::vector<unsigned int> remap(_palette.size(), UNUSED);
+
+        Palette palette;
+
+        for (unsigned int i = 0; i < CHUNK_VOLUME; ++i)
+        {
+            unsigned int& entry = remap[readEntry(_data, _bits, i)];
+
+            if (entry != UNUSED) continue;
+
+            entry = palette.size();
+
+            palette.push_back(_palette[readEntry(_data, _bits, i)]);
+        }
+
+        if (palette.size() == 1)
+        {
+            fill(palette[0]);
+
+            return;
+        }
+
+        unsigned char bits = bitsForPalette(palette.size());
+
+        IndexList data(CHUNK_VOLUME / (64 / bits), 0);
+
+        for (unsigned int i = 0; i < CHUNK_VOLUME; ++i)
+        {
+            writeEntry(data, bits, i, remap[readEntry(_data, _bits, i)]);
+        }
+
+        _palette.swap(palette);
+        _data.swap(data);
+
+        _bits = bits;
+    }
+
+    void Chunk::repack(unsigned char bits)
+    {
+        IndexList data(CHUNK_VOLUME / (64 / bits), 0);
+
+        // Coming from the uniform path all entries are 0 already
+        if (_bits)
+        {
+            for (unsigned int i = 0; i < CHUNK_VOLUME; ++i)
+            {
+                writeEntry(data, bits, i, readEntry(_data, _bits, i));
+            }
+        }
+
+        _data.swap(data);
+
+        _bits = bits;
+    }
+}
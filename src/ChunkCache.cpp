@@ -0,0 +1,63 @@
+#include "ChunkCache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace EJV
+{
+    namespace
+    {
+        struct Candidate
+        {
+            uint32_t lastUsed;
+
+            ChunkIndex::Key key;
+
+            size_t bytes;
+
+            bool operator<(const Candidate& c) const { return lastUsed < c.lastUsed; }
+        };
+    }
+
+    void ChunkCache::selectVictims(const ChunkIndex& chunks, const ChunkTickets& tickets, uint32_t tick, std::vector<Point3D>& victims)
+    {
+        std::vector<Candidate> candidates;
+
+        size_t bytes = 0;
+
+        for (ChunkIndex::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        {
+            size_t size = it->chunk->getMemoryUsage();
+
+            bytes += size;
+
+            // Pending block updates would be lost with the chunk
+            if (_budget && it->lastUsed != tick && !tickets.isTicketed(it->getPoint()) && it->chunk->getScheduledUpdates().empty())
+            {
+                Candidate candidate = { it->lastUsed, it->key, size };
+
+                candidates.push_back(candidate);
+            }
+        }
+
+        _stats.residentBytes = bytes;
+        _stats.residentChunks = chunks.size();
+
+        if (!_budget || bytes <= _budget) return;
+
+        const size_t target = _budget / 100 * _lowWatermark;
+
+        std::sort(candidates.begin(), candidates.end());
+
+        for (std::vector<Candidate>::const_iterator it = candidates.begin(); it != candidates.end() && bytes > target; ++it)
+        {
+            victims.push_back(ChunkIndex::point(it->key));
+
+            bytes -= it->bytes;
+        }
+
+        // The victims are unloaded right away
+        _stats.residentBytes = bytes;
+        _stats.residentChunks -= victims.size();
+    }
+}
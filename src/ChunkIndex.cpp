@@ -0,0 +1,135 @@
+#include "ChunkIndex.hpp"
+
+namespace EJV
+{
+    const ChunkIndex::Entry* ChunkIndex::findEntry(Key key) const
+    {
+        if (!_size) return 0;
+
+        for (unsigned int i = slot(key); ; i = (i + 1) & (_entries.size() - 1))
+        {
+            const Entry& entry = _entries[i];
+
+            if (entry.key == key) return &entry;
+
+            if (entry.key == EMPTY) return 0;
+        }
+    }
+
+    Chunk* ChunkIndex::insert(const Point3D& point, Chunk* chunk)
+    {
+        Key k = key(point);
+
+        // Replacing never moves entries, block updates on the workers rely on it
+        Entry* existing = const_cast<Entry*>(findEntry(k));
+
+        if (existing)
+        {
+            Chunk* replaced = existing->chunk;
+
+            existing->chunk = chunk;
+            existing->lastUsed = 0;
+
+            return replaced;
+        }
+
+        // Grow past a load factor of 0.7
+        if ((_size + 1) * 10 > _entries.size() * 7) rehash(_entries.empty() ? 16 : _entries.size() * 2);
+
+        unsigned int i = slot(k);
+
+        while (_entries[i].key != EMPTY) i = (i + 1) & (_entries.size() - 1);
+
+        Entry& entry = _entries[i];
+
+        ++_size;
+
+        entry.key = k;
+        entry.chunk = chunk;
+        entry.lastUsed = 0;
+
+        return 0;
+    }
+
+    Chunk* ChunkIndex::erase(const Point3D& point)
+    {
+        if (!_size) return 0;
+
+        const unsigned int mask = _entries.size() - 1;
+
+        Key k = key(point);
+
+        unsigned int hole = slot(k);
+
+        while (_entries[hole].key != k)
+        {
+            if (_entries[hole].key == EMPTY) return 0;
+
+            hole = (hole + 1) & mask;
+        }
+
+        Chunk* erased = _entries[hole].chunk;
+
+        // Backward shift deletion, leaves no tombstones behind
+        for (unsigned int i = (hole + 1) & mask; _entries[i].key != EMPTY; i = (i + 1) & mask)
+        {
+            unsigned int home = slot(_entries[i].key);
+
+            // Move the entry if its home slot isn't within (hole, i]
+            if (((i - home) & mask) >= ((i - hole) & mask))
+            {
+                _entries[hole] = _entries[i];
+
+                hole = i;
+            }
+        }
+
+        _entries[hole].key = EMPTY;
+        _entries[hole].chunk = 0;
+        _entries[hole].lastUsed = 0;
+
+        --_size;
+
+        return erased;
+    }
+
+    void ChunkIndex::clear()
+    {
+        EntryList().swap(_entries);
+
+        _size = 0;
+    }
+
+    void ChunkIndex::reserve(unsigned int count)
+    {
+        unsigned int capacity = 16;
+
+        while (count * 10 > capacity * 7) capacity *= 2;
+
+        if (capacity > _entries.size()) rehash(capacity);
+    }
+
+    void ChunkIndex::rehash(unsigned int capacity)
+    {
+        Entry empty;
+
+        empty.key = EMPTY;
+        empty.chunk = 0;
+        empty.lastUsed = 0;
+
+        EntryList entries(capacity, empty);
+
+        entries.swap(_entries);
+
+        for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->key == EMPTY) continue;
+
+            unsigned int i = slot(it->key);
+
+            while (_entries[i].key != EMPTY) i = (i + 1) & (capacity - 1);
+
+            _entries[i] = *it;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#include "ChunkPool.hpp"
+#include "Chunk.hpp"
+
+#include <algorithm>
+
+#include <stdint.h>
+
+#include <sys/mman.h>
+
+namespace EJV
+{
+    namespace
+    {
+        const size_t SLAB_SIZE      = 64 * 1024;
+        const size_t HUGE_SLAB_SIZE = 2 * 1024 * 1024;
+
+        const size_t ALIGNMENT = 16;
+    }
+
+    SlabPool::SlabPool(size_t blockSize) : _free(0), _hugePages(false)
+    {
+        // Blocks hold the free list link and keep their alignment
+        if (blockSize < sizeof(FreeBlock)) blockSize = sizeof(FreeBlock);
+
+        _blockSize = (blockSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+        _stats.live = 0;
+        _stats.peak = 0;
+        _stats.freeCount = 0;
+        _stats.slabs = 0;
+    }
+
+    SlabPool::~SlabPool()
+    {
+        for (std::vector<Slab>::iterator it = _slabs.begin(); it != _slabs.end(); ++it)
+        {
+            if (it->mapped)
+                munmap(it->memory, it->size);
+            else
+                ::operator delete(it->memory);
+        }
+    }
+
+    void* SlabPool::allocate()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_free) grow();
+
+        FreeBlock* block = _free;
+
+        _free = block->next;
+
+        --_stats.freeCount;
+
+        if (++_stats.live > _stats.peak) _stats.peak = _stats.live;
+
+        return block;
+    }
+
+    void SlabPool::free(void* memory)
+    {
+        if (!memory) return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        FreeBlock* block = (FreeBlock*) memory;
+
+        block->next = _free;
+
+        _free = block;
+
+        ++_stats.freeCount;
+
+        --_stats.live;
+    }
+
+    void SlabPool::setHugePages(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _hugePages = enable;
+    }
+
+    SlabPool::Stats SlabPool::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return _stats;
+    }
+
+    void SlabPool::grow()
+    {
+        Slab slab = { 0, SLAB_SIZE, false };
+
+        if (_hugePages)
+        {
+            slab.size = HUGE_SLAB_SIZE;
+
+            // Twice the size, so a huge page aligned slab fits in somewhere
+            void* memory = mmap(0, slab.size * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (memory != MAP_FAILED)
+            {
+                char* start = (char*) memory;
+                char* aligned = (char*) (((uintptr_t) start + HUGE_SLAB_SIZE - 1) & ~(uintptr_t) (HUGE_SLAB_SIZE - 1));
+
+                // Unmap the unaligned head and the tail
+                if (aligned != start) munmap(start, aligned - start);
+
+                munmap(aligned + slab.size, start + slab.size * 2 - (aligned + slab.size));
+
+                memory = aligned;
+
+                #ifdef MADV_HUGEPAGE
+                madvise(memory, slab.size, MADV_HUGEPAGE);
+                #endif
+
+                slab.memory = memory;
+                slab.mapped = true;
+            }
+        }
+
+        // Small slabs, or huge pages weren't available
+        if (!slab.memory)
+        {
+            slab.size = std::max(SLAB_SIZE, _blockSize * 8);
+            slab.memory = ::operator new(slab.size);
+        }
+
+        _slabs.push_back(slab);
+
+        ++_stats.slabs;
+
+        // Thread the new blocks onto the free list, lowest address first
+        char* memory = (char*) slab.memory;
+
+        for (size_t i = slab.size / _blockSize; i-- > 0;)
+        {
+            FreeBlock* block = (FreeBlock*) (memory + i * _blockSize);
+
+            block->next = _free;
+
+            _free = block;
+
+            ++_stats.freeCount;
+        }
+    }
+
+    ChunkPool *ChunkPool::_singleton = 0;
+
+    ChunkPool& ChunkPool::GET()
+    {
+        static std::once_flag created;
+
+        std::call_once(created, []() { _singleton = new ChunkPool; });
+
+        return *_singleton;
+    }
+
+    ChunkPool::ChunkPool()
+    {
+        _pools[0] = new SlabPool(sizeof(Chunk));
+
+        for (unsigned int i = 1, bits = 1; i < POOL_COUNT; ++i, bits *= 2)
+        {
+            _pools[i] = new SlabPool(CHUNK_VOLUME / (64 / bits) * sizeof(uint64_t));
+        }
+    }
+
+    SlabPool* ChunkPool::findPool(size_t size) const
+    {
+        for (unsigned int i = 0; i < POOL_COUNT; ++i)
+        {
+            // Round like SlabPool so that the Chunk size matches too
+            if ((size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT == _pools[i]->getBlockSize()) return _pools[i];
+        }
+
+        return 0;
+    }
+
+    void* ChunkPool::allocate(size_t size)
+    {
+        SlabPool* pool = findPool(size);
+
+        return pool ? pool->allocate() : ::operator new(size);
+    }
+
+    void ChunkPool::free(void* memory, size_t size)
+    {
+        SlabPool* pool = findPool(size);
+
+        if (pool)
+            pool->free(memory);
+        else
+            ::operator delete(memory);
+    }
+
+    void ChunkPool::setHugePages(bool enable)
+    {
+        for (unsigned int i = 0; i < POOL_COUNT; ++i)
+        {
+            _pools[i]->setHugePages(enable);
+        }
+    }
+}
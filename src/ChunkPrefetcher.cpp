@@ -0,0 +1,110 @@
+#include "ChunkPrefetcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EJV
+{
+    namespace
+    {
+        struct Candidate
+        {
+            double score;
+
+            ChunkIndex::Key key;
+
+            bool operator<(const Candidate& c) const { return score < c.score; }
+        };
+
+        inline double distanceSquared(double ax, double ay, double az, double bx, double by, double bz)
+        {
+            return (ax - bx) * (ax - bx) + (ay - by) * (ay - by) + (az - bz) * (az - bz);
+        }
+    }
+
+    void ChunkPrefetcher::addViewer(double x, double y, double z, double velX, double velY, double velZ)
+    {
+        // Nothing sensible to load around a broken position
+        if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) return;
+
+        // Far away viewers share the border chunks of the key range
+        Point3D chunk(ChunkIndex::clampCoordinate(std::floor(x / CHUNK_WIDTH)), ChunkIndex::clampCoordinate(std::floor(y / CHUNK_HEIGHT)),
+                      ChunkIndex::clampCoordinate(std::floor(z / CHUNK_LENGTH)));
+
+        Viewer viewer = { x, y, z, velX, velY, velZ };
+
+        std::pair<ViewerMap::iterator, bool> inserted = _viewers.insert(ViewerMap::value_type(ChunkIndex::key(chunk), viewer));
+
+        if (inserted.second) return;
+
+        Viewer& other = inserted.first->second;
+
+        if (velX * velX + velY * velY + velZ * velZ > other.velX * other.velX + other.velY * other.velY + other.velZ * other.velZ)
+        {
+            other = viewer;
+        }
+    }
+
+    void ChunkPrefetcher::select(const ChunkIndex& loaded, const ChunkRequests& pending, std::vector<Point3D>& chunks)
+    {
+        typedef std::unordered_map<ChunkIndex::Key, double> ScoreMap;
+
+        ScoreMap scores;
+
+        const int r = _radius;
+        const int v = _verticalRadius;
+
+        for (ViewerMap::const_iterator it = _viewers.begin(); it != _viewers.end(); ++it)
+        {
+            const Point3D center = ChunkIndex::point(it->first);
+            const Viewer& viewer = it->second;
+
+            // Where the viewer will be after the lookahead
+            const double aheadX = viewer.x + viewer.velX * _lookahead;
+            const double aheadY = viewer.y + viewer.velY * _lookahead;
+            const double aheadZ = viewer.z + viewer.velZ * _lookahead;
+
+            for (int x = center.x - r; x <= center.x + r; ++x)
+                for (int y = center.y - v; y <= center.y + v; ++y)
+                    for (int z = center.z - r; z <= center.z + r; ++z)
+                    {
+                        ChunkIndex::Key key = ChunkIndex::key(Point3D(x, y, z));
+
+                        const double middleX = (x + 0.5) * CHUNK_WIDTH;
+                        const double middleY = (y + 0.5) * CHUNK_HEIGHT;
+                        const double middleZ = (z + 0.5) * CHUNK_LENGTH;
+
+                        double score = std::min(distanceSquared(middleX, middleY, middleZ, viewer.x, viewer.y, viewer.z),
+                                                distanceSquared(middleX, middleY, middleZ, aheadX, aheadY, aheadZ));
+
+                        std::pair<ScoreMap::iterator, bool> inserted = scores.insert(ScoreMap::value_type(key, score));
+
+                        if (!inserted.second && score < inserted.first->second) inserted.first->second = score;
+                    }
+        }
+
+        _viewers.clear();
+
+        std::vector<Candidate> candidates;
+
+        for (ScoreMap::const_iterator it = scores.begin(); it != scores.end(); ++it)
+        {
+            Point3D point = ChunkIndex::point(it->first);
+
+            if (loaded.find(it->first) || pending.isPending(point)) continue;
+
+            Candidate candidate = { it->second, it->first };
+
+            candidates.push_back(candidate);
+        }
+
+        size_t count = std::min<size_t>(candidates.size(), _maxRequests);
+
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            chunks.push_back(ChunkIndex::point(candidates[i].key));
+        }
+    }
+}
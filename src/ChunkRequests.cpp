@@ -0,0 +1,47 @@
+#include "ChunkRequests.hpp"
+
+namespace EJV
+{
+    bool ChunkRequests::add(const Point3D& point, ChunkCallback callback, void* data)
+    {
+        std::pair<PendingMap::iterator, bool> inserted = _pending.insert(PendingMap::value_type(ChunkIndex::key(point), WaiterList()));
+
+        if (callback)
+        {
+            Waiter waiter = { callback, data };
+
+            inserted.first->second.push_back(waiter);
+        }
+
+        return inserted.second;
+    }
+
+    void ChunkRequests::complete(const Point3D& point, Chunk* chunk)
+    {
+        Completed completed = { point, chunk };
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _completed.push_back(completed);
+    }
+
+    void ChunkRequests::drain(CompletedList& completed)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        completed.insert(completed.end(), _completed.begin(), _completed.end());
+
+        _completed.clear();
+    }
+
+    void ChunkRequests::finish(const Point3D& point, WaiterList& waiters)
+    {
+        PendingMap::iterator it = _pending.find(ChunkIndex::key(point));
+
+        if (it == _pending.end()) return;
+
+        waiters.swap(it->second);
+
+        _pending.erase(it);
+    }
+}
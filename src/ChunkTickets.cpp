@@ -0,0 +1,129 @@
+#include "ChunkTickets.hpp"
+
+namespace EJV
+{
+    ChunkTickets::ID ChunkTickets::acquire(TicketType type, TicketLevel level, const Point3D& center, unsigned int radius, uint64_t expiry, PointList& covered)
+    {
+        Ticket ticket = { type, level, center, radius, expiry };
+
+        ID id = _nextID++;
+
+        _tickets[id] = ticket;
+
+        cover(ticket, covered);
+
+        return id;
+    }
+
+    bool ChunkTickets::release(ID id, PointList& released)
+    {
+        TicketMap::iterator it = _tickets.find(id);
+
+        if (it == _tickets.end()) return false;
+
+        uncover(it->second, released);
+
+        _tickets.erase(it);
+
+        return true;
+    }
+
+    bool ChunkTickets::move(ID id, const Point3D& center, PointList& covered, PointList& released)
+    {
+        TicketMap::iterator it = _tickets.find(id);
+
+        if (it == _tickets.end()) return false;
+
+        if (it->second.center == center) return true;
+
+        Ticket old = it->second;
+
+        it->second.center = center;
+
+        // Cover first so that overlapping chunks never drop to zero
+        cover(it->second, covered);
+        uncover(old, released);
+
+        return true;
+    }
+
+    void ChunkTickets::expire(uint64_t tick, PointList& released)
+    {
+        for (TicketMap::iterator it = _tickets.begin(); it != _tickets.end();)
+        {
+            if (it->second.expiry && it->second.expiry <= tick)
+            {
+                uncover(it->second, released);
+
+                it = _tickets.erase(it);
+            }
+            else ++it;
+        }
+    }
+
+    const ChunkTickets::Ticket* ChunkTickets::getTicket(ID id) const
+    {
+        TicketMap::const_iterator it = _tickets.find(id);
+
+        return it == _tickets.end() ? 0 : &it->second;
+    }
+
+    int ChunkTickets::getLevel(const Point3D& point) const
+    {
+        CountMap::const_iterator it = _chunks.find(ChunkIndex::key(point));
+
+        if (it == _chunks.end()) return -1;
+
+        for (int level = TICKET_LEVEL_COUNT - 1; level > 0; --level)
+        {
+            if (it->second.levels[level]) return level;
+        }
+
+        return TICKET_LEVEL_LOADED;
+    }
+
+    void ChunkTickets::cover(const Ticket& ticket, PointList& covered)
+    {
+        const int r = ticket.radius;
+
+        for (int x = -r; x <= r; ++x)
+            for (int y = -r; y <= r; ++y)
+                for (int z = -r; z <= r; ++z)
+                {
+                    Point3D point(ticket.center.x + x, ticket.center.y + y, ticket.center.z + z);
+
+                    std::pair<CountMap::iterator, bool> inserted = _chunks.insert(CountMap::value_type(ChunkIndex::key(point), Counts()));
+
+                    Counts& counts = inserted.first->second;
+
+                    if (inserted.second) covered.push_back(point);
+
+                    ++counts.levels[ticket.level];
+                    ++counts.total;
+                }
+    }
+
+    void ChunkTickets::uncover(const Ticket& ticket, PointList& released)
+    {
+        const int r = ticket.radius;
+
+        for (int x = -r; x <= r; ++x)
+            for (int y = -r; y <= r; ++y)
+                for (int z = -r; z <= r; ++z)
+                {
+                    Point3D point(ticket.center.x + x, ticket.center.y + y, ticket.center.z + z);
+
+                    CountMap::iterator it = _chunks.find(ChunkIndex::key(point));
+
+                    if (it == _chunks.end()) continue;
+
+                    --it->second.levels[ticket.level];
+
+                    if (--it->second.total) continue;
+
+                    _chunks.erase(it);
+
+                    released.push_back(point);
+                }
+    }
+}
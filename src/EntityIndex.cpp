@@ -0,0 +1,279 @@
+#include "EntityIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EJV
+{
+    EntityIndex::EntityIndex(const EntityStore& store, double cellSize) : _store(store), _cellSize(cellSize > 0 ? cellSize : 16),
+                                                                          _inverseCellSize(1 / _cellSize) {}
+
+    void EntityIndex::setCellSize(double blocks)
+    {
+        if (blocks <= 0) return;
+
+        _cellSize = blocks;
+        _inverseCellSize = 1 / blocks;
+
+        _cells.clear();
+
+        for (unsigned int i = 0; i < _store.size(); ++i)
+        {
+            const uint32_t slot = _store.getSlot(i);
+
+            insertIntoCell(slot, cellOfSlot(slot));
+        }
+    }
+
+    Point3D EntityIndex::cellOf(double x, double y, double z) const
+    {
+        return Point3D(ChunkIndex::clampCoordinate(std::floor(x * _inverseCellSize)), ChunkIndex::clampCoordinate(std::floor(y * _inverseCellSize)),
+                       ChunkIndex::clampCoordinate(std::floor(z * _inverseCellSize)));
+    }
+
+    Point3D EntityIndex::cellOfSlot(uint32_t slot) const
+    {
+        const unsigned int index = _store.getIndexOfSlot(slot);
+
+        return cellOf(_store.posX()[index], _store.posY()[index], _store.posZ()[index]);
+    }
+
+    void EntityIndex::insertIntoCell(uint32_t slot, const Point3D& cell)
+    {
+        SlotList& slots = _cells[ChunkIndex::key(cell)];
+
+        if (slot >= _locations.size()) _locations.resize(slot + 1);
+
+        _locations[slot].cell = cell;
+        _locations[slot].cellSlot = slots.size();
+
+        slots.push_back(slot);
+    }
+
+    void EntityIndex::removeFromCell(uint32_t slot)
+    {
+        const Location& location = _locations[slot];
+
+        CellMap::iterator cell = _cells.find(ChunkIndex::key(location.cell));
+
+        SlotList& slots = cell->second;
+
+        // Swap with the last one
+        slots[location.cellSlot] = slots.back();
+
+        _locations[slots.back()].cellSlot = location.cellSlot;
+
+        slots.pop_back();
+
+        if (slots.empty()) _cells.erase(cell);
+    }
+
+    void EntityIndex::add(EntityHandle entity)
+    {
+        if (!_store.isAlive(entity)) return;
+
+        insertIntoCell(entity.slot, cellOfSlot(entity.slot));
+    }
+
+    void EntityIndex::remove(EntityHandle entity)
+    {
+        if (!_store.isAlive(entity)) return;
+
+        removeFromCell(entity.slot);
+    }
+
+    void EntityIndex::move(EntityHandle entity)
+    {
+        if (!_store.isAlive(entity)) return;
+
+        const Point3D cell = cellOfSlot(entity.slot);
+
+        if (cell == _locations[entity.slot].cell) return;
+
+        removeFromCell(entity.slot);
+
+        insertIntoCell(entity.slot, cell);
+    }
+
+    void EntityIndex::moveAll()
+    {
+        const double* posX = _store.posX();
+        const double* posY = _store.posY();
+        const double* posZ = _store.posZ();
+
+        for (unsigned int i = 0; i < _store.size(); ++i)
+        {
+            const uint32_t slot = _store.getSlot(i);
+
+            const Point3D cell = cellOf(posX[i], posY[i], posZ[i]);
+
+            if (cell == _locations[slot].cell) continue;
+
+            removeFromCell(slot);
+
+            insertIntoCell(slot, cell);
+        }
+    }
+
+    void EntityIndex::clear()
+    {
+        _cells.clear();
+        _locations.clear();
+    }
+
+    void EntityIndex::collect(const SlotList& slots, const Box& box, bool inner, HandleList& found) const
+    {
+        const double* posX = _store.posX();
+        const double* posY = _store.posY();
+        const double* posZ = _store.posZ();
+
+        for (SlotList::const_iterator it = slots.begin(); it != slots.end(); ++it)
+        {
+            const unsigned int index = _store.getIndexOfSlot(*it);
+
+            if (inner || (posX[index] >= box.minX && posX[index] <= box.maxX && posY[index] >= box.minY && posY[index] <= box.maxY &&
+                          posZ[index] >= box.minZ && posZ[index] <= box.maxZ)) found.push_back(_store.getHandle(index));
+        }
+    }
+
+    void EntityIndex::findInBox(double minX, double minY, double minZ, double maxX, double maxY, double maxZ, HandleList& found) const
+    {
+        const Box box = { minX, minY, minZ, maxX, maxY, maxZ };
+
+        const Point3D low = cellOf(minX, minY, minZ);
+        const Point3D high = cellOf(maxX, maxY, maxZ);
+
+        // Huge boxes cover more cells than exist, scan the cells instead
+        const double volume = (double(high.x) - low.x + 1) * (double(high.y) - low.y + 1) * (double(high.z) - low.z + 1);
+
+        if (volume > _cells.size())
+        {
+            for (CellMap::const_iterator cell = _cells.begin(); cell != _cells.end(); ++cell)
+            {
+                const Point3D point = ChunkIndex::point(cell->first);
+
+                if (point.x < low.x || point.x > high.x || point.y < low.y || point.y > high.y || point.z < low.z || point.z > high.z) continue;
+
+                collect(cell->second, box, false, found);
+            }
+
+            return;
+        }
+
+        for (int x = low.x; x <= high.x; ++x)
+        {
+            for (int y = low.y; y <= high.y; ++y)
+            {
+                for (int z = low.z; z <= high.z; ++z)
+                {
+                    CellMap::const_iterator cell = _cells.find(ChunkIndex::key(Point3D(x, y, z)));
+
+                    if (cell == _cells.end()) continue;
+
+                    // Inner cells are inside the box entirely
+                    const bool inner = x != low.x && x != high.x && y != low.y && y != high.y && z != low.z && z != high.z;
+
+                    collect(cell->second, box, inner, found);
+                }
+            }
+        }
+    }
+
+    void EntityIndex::findInRadius(double x, double y, double z, double radius, HandleList& found) const
+    {
+        const size_t first = found.size();
+
+        findInBox(x - radius, y - radius, z - radius, x + radius, y + radius, z + radius, found);
+
+        // Keep the ones inside the sphere
+        const double radiusSquared = radius * radius;
+
+        size_t kept = first;
+
+        for (size_t i = first; i < found.size(); ++i)
+        {
+            const unsigned int index = _store.getIndexOfSlot(found[i].slot);
+
+            const double dx = _store.posX()[index] - x, dy = _store.posY()[index] - y, dz = _store.posZ()[index] - z;
+
+            if (dx * dx + dy * dy + dz * dz <= radiusSquared) found[kept++] = found[i];
+        }
+
+        found.resize(kept);
+    }
+
+    EntityHandle EntityIndex::findNearest(double x, double y, double z, double maxRadius, EntityHandle exclude) const
+    {
+        const Point3D center = cellOf(x, y, z);
+
+        int maxRing = ChunkIndex::clampCoordinate(std::ceil(maxRadius * _inverseCellSize) + 1);
+
+        // Huge radii, nothing lies past the farthest occupied cell
+        if ((2 * double(maxRing) + 1) * (2 * double(maxRing) + 1) > _cells.size())
+        {
+            int farthest = 0;
+
+            for (CellMap::const_iterator cell = _cells.begin(); cell != _cells.end(); ++cell)
+            {
+                const Point3D point = ChunkIndex::point(cell->first);
+
+                farthest = std::max(farthest, std::max(std::abs(point.x - center.x), std::max(std::abs(point.y - center.y), std::abs(point.z - center.z))));
+            }
+
+            maxRing = std::min(maxRing, farthest);
+        }
+
+        const double* posX = _store.posX();
+        const double* posY = _store.posY();
+        const double* posZ = _store.posZ();
+
+        unsigned int nearest = EntityStore::NONE;
+
+        double best = maxRadius * maxRadius;
+
+        // Search shells of cells around the center, nearest first
+        for (int ring = 0; ring <= maxRing; ++ring)
+        {
+            // Anything in this shell or beyond is at least this far away
+            const double reach = (ring - 1) * _cellSize;
+
+            if (reach > 0 && reach * reach > best) break;
+
+            for (int dx = -ring; dx <= ring; ++dx)
+            {
+                for (int dy = -ring; dy <= ring; ++dy)
+                {
+                    // Only the surface of the shell, the inside was searched already
+                    const bool surface = dx == -ring || dx == ring || dy == -ring || dy == ring;
+
+                    for (int dz = -ring; dz <= ring; dz += surface ? 1 : 2 * ring)
+                    {
+                        CellMap::const_iterator cell = _cells.find(ChunkIndex::key(Point3D(center.x + dx, center.y + dy, center.z + dz)));
+
+                        if (cell != _cells.end())
+                        {
+                            for (SlotList::const_iterator it = cell->second.begin(); it != cell->second.end(); ++it)
+                            {
+                                const unsigned int index = _store.getIndexOfSlot(*it);
+
+                                const double ex = posX[index] - x, ey = posY[index] - y, ez = posZ[index] - z;
+
+                                const double distance = ex * ex + ey * ey + ez * ez;
+
+                                if (distance <= best && (*it != exclude.slot || exclude.isNull()))
+                                {
+                                    best = distance;
+                                    nearest = index;
+                                }
+                            }
+                        }
+
+                        if (!ring) break;
+                    }
+                }
+            }
+        }
+
+        return nearest == EntityStore::NONE ? EntityHandle() : _store.getHandle(nearest);
+    }
+}
@@ -0,0 +1,188 @@
+#include "EntityStore.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace EJV
+{
+    namespace
+    {
+        template <typename T>
+        inline void removeSwap(std::vector<T>& column, unsigned int index)
+        {
+            column[index] = column.back();
+
+            column.pop_back();
+        }
+    }
+
+    EntityStore::~EntityStore()
+    {
+        clear();
+    }
+
+    EntityHandle EntityStore::create(unsigned short type, double x, double y, double z, double gravity, double drag)
+    {
+        uint32_t slot;
+
+        if (_freeSlot != NONE)
+        {
+            slot = _freeSlot;
+
+            _freeSlot = _slots[slot].index;
+        }
+        else
+        {
+            slot = _slots.size();
+
+            Slot created = { 0, 1 };
+
+            _slots.push_back(created);
+        }
+
+        _slots[slot].index = _slotOf.size();
+
+        _slotOf.push_back(slot);
+
+        _posX.push_back(x);
+        _posY.push_back(y);
+        _posZ.push_back(z);
+
+        _velX.push_back(0);
+        _velY.push_back(0);
+        _velZ.push_back(0);
+
+        _gravity.push_back(gravity);
+        _drag.push_back(drag);
+
+        _type.push_back(type);
+        _flags.push_back(0);
+        _metadata.push_back(0);
+
+        return EntityHandle(slot, _slots[slot].generation);
+    }
+
+    void EntityStore::destroy(EntityHandle entity)
+    {
+        const unsigned int index = find(entity);
+
+        if (index == NONE) return;
+
+        delete _metadata[index];
+
+        // The last entity takes the free index
+        _slots[_slotOf.back()].index = index;
+
+        removeSwap(_slotOf, index);
+
+        removeSwap(_posX, index);
+        removeSwap(_posY, index);
+        removeSwap(_posZ, index);
+
+        removeSwap(_velX, index);
+        removeSwap(_velY, index);
+        removeSwap(_velZ, index);
+
+        removeSwap(_gravity, index);
+        removeSwap(_drag, index);
+
+        removeSwap(_type, index);
+        removeSwap(_flags, index);
+        removeSwap(_metadata, index);
+
+        // Outdates the handles, 0 is kept for null handles
+        Slot& slot = _slots[entity.slot];
+
+        if (!++slot.generation) slot.generation = 1;
+
+        slot.index = _freeSlot;
+
+        _freeSlot = entity.slot;
+    }
+
+    void EntityStore::clear()
+    {
+        while (!_slotOf.empty()) destroy(getHandle(_slotOf.size() - 1));
+    }
+
+    Metadata& EntityStore::getMetadata(unsigned int index)
+    {
+        if (!_metadata[index]) _metadata[index] = new Metadata;
+
+        return *_metadata[index];
+    }
+
+    void EntityStore::integrate()
+    {
+        const unsigned int count = size();
+
+        if (!count) return;
+
+        double* posX = _posX.data();
+        double* posY = _posY.data();
+        double* posZ = _posZ.data();
+
+        double* velX = _velX.data();
+        double* velY = _velY.data();
+        double* velZ = _velZ.data();
+
+        const double* gravity = _gravity.data();
+        const double* drag = _drag.data();
+
+        unsigned int i = 0;
+
+#ifdef __AVX__
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m256d vx = _mm256_loadu_pd(velX + i);
+            const __m256d vy = _mm256_loadu_pd(velY + i);
+            const __m256d vz = _mm256_loadu_pd(velZ + i);
+
+            const __m256d d = _mm256_loadu_pd(drag + i);
+
+            _mm256_storeu_pd(posX + i, _mm256_add_pd(_mm256_loadu_pd(posX + i), vx));
+            _mm256_storeu_pd(posY + i, _mm256_add_pd(_mm256_loadu_pd(posY + i), vy));
+            _mm256_storeu_pd(posZ + i, _mm256_add_pd(_mm256_loadu_pd(posZ + i), vz));
+
+            _mm256_storeu_pd(velX + i, _mm256_mul_pd(vx, d));
+            _mm256_storeu_pd(velY + i, _mm256_mul_pd(_mm256_sub_pd(vy, _mm256_loadu_pd(gravity + i)), d));
+            _mm256_storeu_pd(velZ + i, _mm256_mul_pd(vz, d));
+        }
+#endif
+
+#ifdef __SSE2__
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128d vx = _mm_loadu_pd(velX + i);
+            const __m128d vy = _mm_loadu_pd(velY + i);
+            const __m128d vz = _mm_loadu_pd(velZ + i);
+
+            const __m128d d = _mm_loadu_pd(drag + i);
+
+            _mm_storeu_pd(posX + i, _mm_add_pd(_mm_loadu_pd(posX + i), vx));
+            _mm_storeu_pd(posY + i, _mm_add_pd(_mm_loadu_pd(posY + i), vy));
+            _mm_storeu_pd(posZ + i, _mm_add_pd(_mm_loadu_pd(posZ + i), vz));
+
+            _mm_storeu_pd(velX + i, _mm_mul_pd(vx, d));
+            _mm_storeu_pd(velY + i, _mm_mul_pd(_mm_sub_pd(vy, _mm_loadu_pd(gravity + i)), d));
+            _mm_storeu_pd(velZ + i, _mm_mul_pd(vz, d));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            posX[i] += velX[i];
+            posY[i] += velY[i];
+            posZ[i] += velZ[i];
+
+            velX[i] *= drag[i];
+            velY[i] = (velY[i] - gravity[i]) * drag[i];
+            velZ[i] *= drag[i];
+        }
+    }
+}
@@ -4,8 +4,32 @@
 #include "Loader.hpp"
 #include "Generator.hpp"
 #include "Rules.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_set>
+
 namespace EJV
 {
+    namespace
+    {
+        inline int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+        inline Point3D chunkOf(double x, double y, double z)
+        {
+            return Point3D(ChunkIndex::clampCoordinate(std::floor(x / CHUNK_WIDTH)), ChunkIndex::clampCoordinate(std::floor(y / CHUNK_HEIGHT)),
+                           ChunkIndex::clampCoordinate(std::floor(z / CHUNK_LENGTH)));
+        }
+    }
+
+    void splitBlockPosition(const Point3D& block, Point3D& chunk, Point3D& local)
+    {
+        chunk = Point3D(floorDiv(block.x, CHUNK_WIDTH), floorDiv(block.y, CHUNK_HEIGHT), floorDiv(block.z, CHUNK_LENGTH));
+
+        local = Point3D(block.x - chunk.x * CHUNK_WIDTH, block.y - chunk.y * CHUNK_HEIGHT, block.z - chunk.z * CHUNK_LENGTH);
+    }
+
     State *State::_singleton = 0;
 
     State& State::GET()
@@ -13,6 +37,23 @@ namespace EJV
         return _singleton ? *_singleton : *(_singleton = new State);
     }
 
+    World::World(const std::string& name) : worldName(name), entityIndex(entities), randomTicker(State::GET().blockProperties),
+                                            generator(0), loader(0), ticks(0), overloaded(false), autosaver(this)
+    {
+        TickProfiler& profiler = State::GET().profiler;
+
+        phases.update   = profiler.getPhase(name + "/update");
+        phases.install  = profiler.getPhase(name + "/install");
+        phases.blocks   = profiler.getPhase(name + "/blocks");
+        phases.entities = profiler.getPhase(name + "/entities");
+        phases.prefetch = profiler.getPhase(name + "/prefetch");
+        phases.unload   = profiler.getPhase(name + "/unload");
+        phases.autosave = profiler.getPhase(name + "/autosave");
+        phases.evict    = profiler.getPhase(name + "/evict");
+        phases.load     = profiler.getPhase(name + "/chunk load");
+        phases.save     = profiler.getPhase(name + "/chunk save");
+    }
+
     void World::initProviders()
     {
         generator->init();
@@ -24,142 +65,897 @@ namespace EJV
 
     Chunk* World::getChunk(const Point3D& point)
     {
-        Chunk*& chunk = loadedChunks[point];
+        ChunkMap::Entry* entry = loadedChunks.lookup(point);
+
+        if (entry)
+        {
+            cache.recordHit();
+
+            entry->lastUsed = ticks;
+
+            return entry->chunk;
+        }
+
+        cache.recordMiss();
+
+        Chunk* chunk = provideChunk(point);
+
+        if (!chunk) return 0;
+
+        loadedChunks.insert(point, chunk);
+        loadedChunks.lookup(point)->lastUsed = ticks;
+
+        wakeScheduledUpdates(point, chunk);
+
+        return chunk;
+    }
+
+    Chunk* World::editChunk(const Point3D& point)
+    {
+        Chunk* chunk = getChunk(point);
+
+        if (!chunk || !chunk->isShared()) return chunk;
+
+        // Copy on write
+        chunk = new Chunk(*chunk);
+
+        loadedChunks.insert(point, chunk);
+        loadedChunks.lookup(point)->lastUsed = ticks;
+
+        return chunk;
+    }
+
+    Chunk::BlockID World::getBlock(const Point3D& block)
+    {
+        Point3D point, local;
+
+        splitBlockPosition(block, point, local);
+
+        Chunk* chunk = getChunk(point);
+
+        return chunk ? chunk->getBlock(local.x, local.y, local.z) : 0;
+    }
+
+    void World::setBlock(const Point3D& block, Chunk::BlockID id)
+    {
+        Point3D point, local;
+
+        splitBlockPosition(block, point, local);
+
+        Chunk* chunk = getChunk(point);
+
+        // Don't materialize shared chunks for writes that change nothing
+        if (!chunk || chunk->getBlock(local.x, local.y, local.z) == id) return;
+
+        editChunk(point)->setBlock(local.x, local.y, local.z, id);
+    }
+
+    bool World::requestChunk(const Point3D& point, ChunkCallback callback, void* data)
+    {
+        ChunkMap::Entry* entry = loadedChunks.lookup(point);
+
+        if (entry)
+        {
+            cache.recordHit();
+
+            entry->lastUsed = ticks;
+
+            if (callback) callback(this, point, entry->chunk, data);
+
+            return true;
+        }
+
+        // Only the first request for a chunk starts a job
+        if (requests.add(point, callback, data))
+        {
+            cache.recordMiss();
+
+            State::GET().getWorkers().submit([this, point]()
+            {
+                requests.complete(point, provideChunk(point));
+            });
+        }
+
+        return false;
+    }
+
+    void World::installChunks()
+    {
+        ChunkRequests::CompletedList completed;
 
-        if (chunk) return chunk;
+        requests.drain(completed);
 
-        // If chunk isn't loaded, try to load it
-        chunk = loader->loadChunk(point.x, point.y, point.z);
+        for (ChunkRequests::CompletedList::const_iterator it = completed.begin(); it != completed.end(); ++it)
+        {
+            Chunk* chunk = it->chunk;
+
+            ChunkMap::Entry* entry = loadedChunks.lookup(it->point);
+
+            // The chunk may have been loaded synchronously in the meantime
+            if (entry)
+            {
+                if (chunk) discardChunk(it->point, chunk);
+
+                chunk = entry->chunk;
+            }
+            else if (chunk)
+            {
+                loadedChunks.insert(it->point, chunk);
+                loadedChunks.lookup(it->point)->lastUsed = ticks;
+
+                wakeScheduledUpdates(it->point, chunk);
+            }
+
+            ChunkRequests::WaiterList waiters;
+
+            requests.finish(it->point, waiters);
+
+            for (ChunkRequests::WaiterList::const_iterator waiter = waiters.begin(); waiter != waiters.end(); ++waiter)
+            {
+                waiter->callback(this, it->point, chunk, waiter->data);
+            }
+        }
+    }
+
+    Chunk* World::provideChunk(const Point3D& point)
+    {
+        TickProfiler::Scope scope(State::GET().profiler, phases.load);
+
+        Chunk* chunk;
+
+        {
+            std::lock_guard<std::mutex> lock(loader->mutex);
+
+            Tracer::Scope trace("loadChunk", point);
+
+            // Try to load the chunk
+            chunk = loader->loadChunk(point.x, point.y, point.z);
+        }
+
+        // Loaded chunks match the disk, generated ones stay dirty
+        if (chunk && !chunk->isShared()) chunk->markSaved();
 
         // If chunk doesn't exist, generate it
-        if (!chunk) chunk = generator->generateChunk(point.x, point.y, point.z);
+        if (!chunk)
+        {
+            Tracer::Scope trace("generateChunk", point);
+
+            chunk = generator->generateChunk(point.x, point.y, point.z);
+        }
+
+        // Nothing becomes resident, the loader still counted the attempt
+        if (!chunk) discardChunk(point, 0);
 
         return chunk;
     }
 
     Chunk* World::loadChunk(const Point3D& point)
     {
-        Chunk*& chunk = loadedChunks[point];
+        Chunk* chunk = provideChunk(point);
 
-        chunk = loader->loadChunk(point.x, point.y, point.z);
+        if (!chunk) return 0;
 
-        // If chunk doesn't exist, generate it
-        if (!chunk) chunk = generator->generateChunk(point.x, point.y, point.z);
+        autosaver.cancel(point);
+
+        // Discard the previous version
+        Chunk* previous = loadedChunks.insert(point, chunk);
+
+        if (previous) discardChunk(point, previous);
+
+        loadedChunks.lookup(point)->lastUsed = ticks;
+
+        wakeScheduledUpdates(point, chunk);
 
         return chunk;
     }
 
     void World::unloadChunk(const Point3D& point)
     {
-        ChunkMap::iterator it = loadedChunks.find(point);
+        Chunk* chunk = loadedChunks.erase(point);
 
         // Make sure chunk is loded
-        if (it == loadedChunks.end()) return;
+        if (!chunk) return;
+
+        autosaver.cancel(point);
+
+        // Its pending updates go with it
+        holdScheduledUpdates(point, 0);
+
+        // Save chunk to disk if changed and let the loader drop its copy
+        {
+            TickProfiler::Scope scope(State::GET().profiler, phases.save);
+
+            std::lock_guard<std::mutex> lock(loader->mutex);
 
-        // Save chunk to disk
-        loader->putChunk(point.x, point.y, point.z, it->second);
+            if (chunk->isDirty())
+            {
+                Tracer::Scope trace("putChunk", point);
+
+                loader->putChunk(point.x, point.y, point.z, chunk);
+            }
+
+            if (loader->releaseChunk) loader->releaseChunk(point.x, point.y, point.z, chunk);
+        }
 
         // Unload chunk
-        delete it->second;
+        Chunk::release(chunk);
+    }
+
+    void World::discardChunk(const Point3D& point, Chunk* chunk)
+    {
+        {
+            std::lock_guard<std::mutex> lock(loader->mutex);
+
+            if (loader->releaseChunk) loader->releaseChunk(point.x, point.y, point.z, chunk);
+        }
+
+        Chunk::release(chunk);
+    }
+
+    void World::evictChunks()
+    {
+        std::vector<Point3D> victims;
+
+        cache.selectVictims(loadedChunks, tickets, ticks, victims);
+
+        for (std::vector<Point3D>::const_iterator it = victims.begin(); it != victims.end(); ++it)
+        {
+            unloadChunk(*it);
+
+            cache.recordEviction();
+        }
+    }
+
+    EntityHandle World::spawnEntity(unsigned short type, double x, double y, double z)
+    {
+        const EntityInfo* info = State::GET().entities.find(type);
+
+        // Nobody registered the type
+        if (!info) return EntityHandle();
+
+        EntityHandle entity = entities.create(type, x, y, z, info->gravity, info->drag);
+
+        entityIndex.add(entity);
+
+        // Keeps the chunks around it loaded and ticking, follows it in moveEntityTickets
+        if (info->ticketRadius)
+        {
+            const Point3D chunk = chunkOf(x, y, z);
+
+            EntityTicket ticket = { addTicket(info->ticketType, TICKET_LEVEL_ENTITY_TICKING, chunk, info->ticketRadius), chunk };
+
+            entityTickets[entity.slot] = ticket;
+        }
+
+        return entity;
+    }
+
+    void World::despawnEntity(EntityHandle entity)
+    {
+        if (!entities.isAlive(entity)) return;
+
+        std::unordered_map<uint32_t, EntityTicket>::iterator it = entityTickets.find(entity.slot);
+
+        if (it != entityTickets.end())
+        {
+            ChunkTickets::ID id = it->second.id;
+
+            entityTickets.erase(it);
+
+            removeTicket(id);
+        }
+
+        entityIndex.remove(entity);
+
+        entities.destroy(entity);
+    }
+
+    void World::moveEntityTickets()
+    {
+        for (std::unordered_map<uint32_t, EntityTicket>::iterator it = entityTickets.begin(); it != entityTickets.end(); ++it)
+        {
+            const unsigned int i = entities.getIndexOfSlot(it->first);
+
+            const Point3D chunk = chunkOf(entities.posX()[i], entities.posY()[i], entities.posZ()[i]);
+
+            if (chunk == it->second.chunk) continue;
+
+            it->second.chunk = chunk;
+
+            moveTicket(it->second.id, chunk);
+        }
+    }
 
-        loadedChunks.erase(it);
+    void World::prefetchChunks()
+    {
+        for (unsigned int i = 0; i < entities.size(); ++i)
+        {
+            prefetcher.addViewer(entities.posX()[i], entities.posY()[i], entities.posZ()[i],
+                                 entities.velX()[i], entities.velY()[i], entities.velZ()[i]);
+        }
+
+        std::vector<Point3D> chunks;
+
+        prefetcher.select(loadedChunks, requests, chunks);
+
+        for (std::vector<Point3D>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        {
+            requestChunk(*it);
+        }
     }
 
-    void World::saveWorld() const
+    ChunkTickets::ID World::addTicket(TicketType type, TicketLevel level, const Point3D& center, unsigned int radius, unsigned int duration)
     {
+        ChunkTickets::PointList covered;
+
+        ChunkTickets::ID id = tickets.acquire(type, level, center, radius, duration ? ticks + duration : 0, covered);
+
+        for (ChunkTickets::PointList::const_iterator it = covered.begin(); it != covered.end(); ++it)
+        {
+            requestChunk(*it);
+        }
+
+        return id;
+    }
+
+    void World::moveTicket(ChunkTickets::ID id, const Point3D& center)
+    {
+        ChunkTickets::PointList covered, released;
+
+        tickets.move(id, center, covered, released);
+
+        for (ChunkTickets::PointList::const_iterator it = covered.begin(); it != covered.end(); ++it)
+        {
+            requestChunk(*it);
+        }
+
+        for (ChunkTickets::PointList::const_iterator it = released.begin(); it != released.end(); ++it)
+        {
+            unloadChunk(*it);
+        }
+    }
+
+    void World::removeTicket(ChunkTickets::ID id)
+    {
+        ChunkTickets::PointList released;
+
+        tickets.release(id, released);
+
+        for (ChunkTickets::PointList::const_iterator it = released.begin(); it != released.end(); ++it)
+        {
+            unloadChunk(*it);
+        }
+    }
+
+    unsigned int World::saveWorld()
+    {
+        TickProfiler::Scope scope(State::GET().profiler, phases.save);
+
+        std::lock_guard<std::mutex> lock(loader->mutex);
+
+        unsigned int saved = 0;
+
         for (ChunkMap::const_iterator it = loadedChunks.begin(); it != loadedChunks.end(); ++it)
         {
-            loader->putChunk(it->first.x, it->first.y, it->first.z, it->second);
+            Chunk* chunk = it->chunk;
+
+            // Only write what changed since the last save
+            if (!chunk->isDirty()) continue;
+
+            uint32_t count = chunk->getModificationCount();
+
+            Point3D point = it->getPoint();
+
+            // Older autosave copies must not overwrite this
+            autosaver.cancel(point);
+
+            {
+                Tracer::Scope trace("putChunk", point);
+
+                loader->putChunk(point.x, point.y, point.z, chunk);
+            }
+
+            chunk->markSaved(count);
+
+            ++saved;
+        }
+
+        return saved;
+    }
+
+    bool World::scheduleUpdate(const Point3D& block, unsigned int delay, int priority)
+    {
+        Point3D point, local;
+
+        splitBlockPosition(block, point, local);
+
+        Chunk* chunk = editChunk(point);
+
+        if (!chunk) return false;
+
+        ScheduledUpdates& updates = chunk->editScheduledUpdates();
+
+        const uint64_t tick = ticks + delay;
+
+        const bool earlier = updates.empty() || tick < updates.getNextTick();
+
+        if (!updates.schedule(Chunk::index(local.x, local.y, local.z), tick, priority)) return false;
+
+        // The chunk belongs to the caller's region, the rest of the world doesn't
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+
+        if (earlier) updateWheel.add(ChunkIndex::key(point), tick);
+
+        holdScheduledUpdates(point, chunk);
+
+        return true;
+    }
+
+    void World::wakeScheduledUpdates(const Point3D& point, const Chunk* chunk)
+    {
+        // Updates that came due while unloaded run on the next update
+        const ScheduledUpdates& updates = chunk->getScheduledUpdates();
+
+        if (!updates.empty()) updateWheel.add(ChunkIndex::key(point), updates.getNextTick());
+
+        holdScheduledUpdates(point, chunk);
+    }
+
+    void World::holdScheduledUpdates(const Point3D& point, const Chunk* chunk)
+    {
+        const ChunkIndex::Key key = ChunkIndex::key(point);
+
+        std::unordered_map<ChunkIndex::Key, ChunkTickets::ID>::iterator it = updateTickets.find(key);
+
+        const bool pending = chunk && !chunk->getScheduledUpdates().empty();
+
+        if (pending == (it != updateTickets.end())) return;
+
+        ChunkTickets::PointList points;
+
+        if (pending)
+        {
+            // The chunk is resident, nothing to request
+            updateTickets[key] = tickets.acquire(TICKET_BLOCK_UPDATE, TICKET_LEVEL_LOADED, point, 0, 0, points);
+        }
+        else
+        {
+            // Released chunks stay until the cache evicts them
+            tickets.release(it->second, points);
+
+            updateTickets.erase(it);
+        }
+    }
+
+    namespace
+    {
+        struct DueUpdate
+        {
+            ScheduledUpdates::Entry entry;
+
+            Point3D block;
+
+            bool operator<(const DueUpdate& u) const
+            {
+                if (entry.tick != u.entry.tick) return entry.tick < u.entry.tick;
+                if (entry.priority != u.entry.priority) return entry.priority < u.entry.priority;
+
+                return block < u.block;
+            }
+        };
+    }
+
+    void World::takeDueUpdates(BlockUpdateScheduler::BlockList& blocks)
+    {
+        UpdateWheel::KeyList chunks;
+
+        updateWheel.advance(ticks, chunks);
+
+        std::vector<DueUpdate> due;
+
+        ScheduledUpdates::EntryList entries;
+
+        for (UpdateWheel::KeyList::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        {
+            Point3D point = ChunkIndex::point(*it);
+
+            ChunkMap::Entry* entry = loadedChunks.lookup(point);
+
+            // Unloaded chunks keep their updates until they come back, reloaded ones may have none
+            if (!entry || entry->chunk->getScheduledUpdates().empty()) continue;
+
+            ScheduledUpdates& updates = entry->chunk->editScheduledUpdates();
+
+            entries.clear();
+
+            updates.popDue(ticks, entries);
+
+            if (!updates.empty()) updateWheel.add(*it, updates.getNextTick());
+
+            holdScheduledUpdates(point, entry->chunk);
+
+            for (ScheduledUpdates::EntryList::const_iterator e = entries.begin(); e != entries.end(); ++e)
+            {
+                Point3D local = Chunk::position(e->index);
+
+                DueUpdate update = { *e, Point3D(point.x * CHUNK_WIDTH + local.x, point.y * CHUNK_HEIGHT + local.y, point.z * CHUNK_LENGTH + local.z) };
+
+                due.push_back(update);
+            }
+        }
+
+        // Chunks wake in key order, the updates run in schedule order
+        std::sort(due.begin(), due.end());
+
+        for (std::vector<DueUpdate>::const_iterator it = due.begin(); it != due.end(); ++it)
+        {
+            blocks.push_back(it->block);
+        }
+    }
+
+    bool World::deferUnloadedReach(BlockUpdateScheduler::BlockList& blocks)
+    {
+        std::vector<Point3D> reached;
+
+        blockUpdates.getReachedChunks(reached);
+
+        std::unordered_set<ChunkIndex::Key> missing;
+
+        for (std::vector<Point3D>::const_iterator it = reached.begin(); it != reached.end(); ++it)
+        {
+            ChunkMap::Entry* entry = loadedChunks.lookup(*it);
+
+            if (entry)
+            {
+                // Not evicted while the updates run
+                entry->lastUsed = ticks;
+            }
+            else
+            {
+                missing.insert(ChunkIndex::key(*it));
+
+                requestChunk(*it);
+            }
+        }
+
+        if (missing.empty()) return false;
+
+        const int reach = blockUpdates.getReach();
+
+        std::unordered_map<ChunkIndex::Key, bool> complete; // By chunk of the updates
+
+        BlockUpdateScheduler::BlockList ready;
+
+        for (BlockUpdateScheduler::BlockList::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            Point3D chunk, local;
+
+            splitBlockPosition(*it, chunk, local);
+
+            std::pair<std::unordered_map<ChunkIndex::Key, bool>::iterator, bool> known = complete.insert(std::make_pair(ChunkIndex::key(chunk), true));
+
+            if (known.second)
+            {
+                for (int x = -reach; x <= reach && known.first->second; ++x)
+                for (int y = -reach; y <= reach && known.first->second; ++y)
+                for (int z = -reach; z <= reach && known.first->second; ++z)
+                {
+                    if (missing.count(ChunkIndex::key(Point3D(chunk.x + x, chunk.y + y, chunk.z + z)))) known.first->second = false;
+                }
+            }
+
+            if (known.first->second) ready.push_back(*it);
+            else deferredUpdates.push_back(*it);
+        }
+
+        blocks.swap(ready);
+
+        return true;
+    }
+
+    void World::takeRandomTicks(BlockUpdateScheduler::BlockList& blocks)
+    {
+        randomTicker.begin();
+
+        if (!randomTicker.getSpeed()) return;
+
+        for (ChunkMap::const_iterator it = loadedChunks.begin(); it != loadedChunks.end(); ++it)
+        {
+            if (!randomTicker.consider(*it->chunk)) continue;
+
+            // Overloaded, chunks take turns and get their random ticks every other tick
+            if (overloaded && (it->key + ticks) % 2) continue;
+
+            Point3D point = it->getPoint();
+
+            if (tickets.getLevel(point) < TICKET_LEVEL_TICKING) continue;
+
+            randomTicker.select(point, *it->chunk, ticks, blocks);
         }
     }
 
     void World::update()
     {
-        // Update blocks
-        for (ChunkUpdatesList::iterator it = chunkUpdates.begin(); it != chunkUpdates.end(); ++it)
+        TickProfiler& profiler = State::GET().profiler;
+
+        TickProfiler::Scope scope(profiler, phases.update);
+
+        Tracer::Scope trace("World::update", worldName.c_str());
+
+        // Install chunks finished by the workers
         {
-            updateBlock(it->second, it->first);
+            TickProfiler::Scope scope(profiler, phases.install);
+
+            installChunks();
+        }
+
+        // Run the block updates due this tick
+        {
+            TickProfiler::Scope scope(profiler, phases.blocks);
+
+            BlockUpdateScheduler::BlockList updates;
+
+            updates.swap(deferredUpdates);
+
+            takeDueUpdates(updates);
+
+            takeRandomTicks(updates);
+
+            if (!updates.empty())
+            {
+                blockUpdates.partition(updates);
+
+                // Nothing may load chunks once the updates run concurrently
+                if (blockUpdates.isParallelPass() && deferUnloadedReach(updates)) blockUpdates.partition(updates);
+
+                blockUpdates.run(State::GET().getWorkers(), [this](const Point3D& block) { updateBlock(block); });
+            }
         }
 
         // Update entities
-        for (EntityList::iterator it = entities.begin(); it != entities.end(); ++it)
         {
-            // Fetch entity information
-            EntityInfo& info = State::GET().getMetadata<EntityInfo>((*it)->type);
+            TickProfiler::Scope scope(profiler, phases.entities);
+
+            Registry<EntityInfo>& entityTypes = State::GET().entities;
 
-            // Update entity
-            if (info.updateFunc)
+            // Motion of all entities at once, the updates see where they ended up
+            entities.integrate();
+
+            // By index, updates may spawn or remove entities
+            for (unsigned int i = 0; i < entities.size(); ++i)
             {
-                info.updateFunc(this, *it, info);
+                const EntityHandle entity = entities.getHandle(i);
+
+                // Fetch entity information
+                EntityInfo& info = entityTypes[entities.type()[i]];
+
+                // Update entity
+                if (info.updateFunc)
+                {
+                    info.updateFunc(this, entity, info);
+
+                    // Removed itself, the last entity took its place
+                    if (i >= entities.size() || entities.getHandle(i) != entity) --i;
+                }
             }
+
+            entityIndex.moveAll();
+
+            moveEntityTickets();
+        }
+
+        // Load ahead of the entities
+        if (!overloaded && prefetcher.isPassDue(ticks))
+        {
+            TickProfiler::Scope scope(profiler, phases.prefetch);
+
+            prefetchChunks();
+        }
+
+        // Unload chunks whose last ticket expired
+        {
+            TickProfiler::Scope scope(profiler, phases.unload);
+
+            ChunkTickets::PointList released;
+
+            tickets.expire(ticks, released);
+
+            for (ChunkTickets::PointList::const_iterator it = released.begin(); it != released.end(); ++it)
+            {
+                unloadChunk(*it);
+            }
+        }
+
+        // Save dirty chunks in the background
+        {
+            TickProfiler::Scope scope(profiler, phases.autosave);
+
+            autosaver.update(ticks);
+        }
+
+        // Keep loaded chunks within the memory budget
+        if (cache.isPassDue(ticks))
+        {
+            TickProfiler::Scope scope(profiler, phases.evict);
+
+            evictChunks();
         }
     }
 
-    void World::updateBlock(Chunk* chunk, const Point3D& point)
+    void World::updateBlock(const Point3D& block)
     {
+        Point3D point, local;
+
+        splitBlockPosition(block, point, local);
+
+        Chunk* chunk = getChunk(point);
+
         // Make sure that the chunk is valid
         if (!chunk) return;
 
-        // Fetch block information
-        BlockInfo& info = State::GET().getMetadata<BlockInfo>(chunk->blocks[point.x][point.y][point.z].ID);
+        // Fetch block information, chunks may hold IDs no module registered
+        BlockInfo* info = State::GET().blocks.find(chunk->getBlock(local.x, local.y, local.z));
 
         // Update block
-        if (info.updateFunc)
+        if (info && info->updateFunc)
         {
-            info.updateFunc(this, point, info);
+            info->updateFunc(this, block, *info);
         }
     }
 
     bool State::gameTick()
     {
-        // Update worlds
-        for (WorldList::iterator it = loadedWorlds.begin(); it != loadedWorlds.end(); ++it)
         {
-            ++(*it)->ticks;
+            TickProfiler::Scope scope(profiler, _tickPhase);
 
-           (*it)->update();
-        }
+            Tracer::Scope trace("gameTick");
 
-        // Pass control to modules
-        for (ActionList::iterator it = actions.begin(); it != actions.end(); ++it)
-        {
-            for (RuleModuleList::iterator mod = _rules.begin(); mod != _rules.end(); ++mod)
+            // Actions pushed from now on wait for the next tick
+            actionArena.flip();
+
+            actions.drain(_actionBatch);
+
+            // Update worlds
+            if (_parallelWorlds && loadedWorlds.size() > 1)
+            {
+                // Returns once every world is done, before the modules run
+                getWorkers().parallelFor(loadedWorlds.size(), [this](unsigned int i)
+                {
+                    World* world = loadedWorlds[i];
+
+                    ++world->ticks;
+
+                    world->update();
+                });
+            }
+            else
             {
-                (*mod)->tick(*it);
+                for (WorldList::iterator it = loadedWorlds.begin(); it != loadedWorlds.end(); ++it)
+                {
+                    ++(*it)->ticks;
+
+                    (*it)->update();
+                }
             }
+
+            // Pass control to modules
+            dispatchActions();
+
+            _actionBatch.clear();
+
+            // Every action allocated before the flip was dispatched by now
+            actionArena.release();
         }
 
-        actions.clear();
+        profiler.endTick();
 
         return true;
     }
 
+    bool State::pushAction(const ActionArena::Writer& writer, Action::Base* action)
+    {
+        // Another arena is never flipped or released with this queue
+        if (&writer.getArena() != &actionArena) throw std::runtime_error("Action made by another arena");
+
+        return actions.push(action);
+    }
+
+    void State::dispatchActions()
+    {
+        if (_actionBatch.empty()) return;
+
+        ActionMask present = 0;
+
+        for (ActionQueue::ActionList::const_iterator it = _actionBatch.begin(); it != _actionBatch.end(); ++it)
+        {
+            present |= actionBit((*it)->type);
+        }
+
+        unsigned int i = 0;
+
+        for (RuleModuleList::iterator mod = _rules.begin(); mod != _rules.end(); ++mod, ++i)
+        {
+            RuleModule& module = **mod;
+
+            const ActionMask wanted = module.actionMask & present;
+
+            if (!wanted) continue;
+
+            const ActionQueue::ActionList* actions = &_actionBatch;
+
+            // Only some of the actions are wanted, hand over those
+            if (wanted != present)
+            {
+                _moduleBatch.clear();
+
+                for (ActionQueue::ActionList::const_iterator it = _actionBatch.begin(); it != _actionBatch.end(); ++it)
+                {
+                    if (wanted & actionBit((*it)->type)) _moduleBatch.push_back(*it);
+                }
+
+                actions = &_moduleBatch;
+            }
+
+            TickProfiler::Scope scope(profiler, _rulePhases[i]);
+
+            Tracer::Scope trace("RuleModule::tick", module.getPath().c_str());
+
+            if (module.tickActions)
+            {
+                module.tickActions(actions->data(), actions->size());
+            }
+            else
+            {
+                for (ActionQueue::ActionList::const_iterator it = actions->begin(); it != actions->end(); ++it) module.tick(*it);
+            }
+        }
+    }
+
     void State::run()
     {
-        while (gameTick())
+        Tracer::GET().nameThread("tick");
+
+        _scheduler.start();
+
+        for (;;)
         {
-            ++_ticks;
+            // Sleep until the tick is due, unless catching up
+            _scheduler.wait();
 
-            // Get current time
-            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            for (WorldList::iterator it = loadedWorlds.begin(); it != loadedWorlds.end(); ++it)
+            {
+                (*it)->overloaded = _scheduler.isOverloaded();
+            }
 
-            // Calculate delta time
-            std::chrono::duration<double> time_span = std::chrono::duration_cast<std::chrono::duration<double> >(now - _before);
+            if (!gameTick()) break;
 
-            double dt = time_span.count();
+            ++_ticks;
 
-            // Wait
-            //if (dt < _tickDuration) std::thread::sleep_for();
+            _scheduler.finish();
+        }
 
-            _before = std::chrono::steady_clock::now();
+        // Chunks still loaded keep their changes and scheduled updates
+        for (WorldList::iterator it = loadedWorlds.begin(); it != loadedWorlds.end(); ++it)
+        {
+            (*it)->saveWorld();
         }
     }
 
+    ThreadPool& State::getWorkers()
+    {
+        // Worlds updating in parallel may get here first at the same time
+        std::call_once(_workersCreated, [this]() { _workers = new ThreadPool; });
+
+        return *_workers;
+    }
+
     void State::registerRuleModule(RuleModule* module)
     {
         if (!module) return;
 
         _rules.push_back(module);
+
+        _rulePhases.push_back(profiler.getPhase("rules " + module->getPath()));
     }
 
     void State::registerUIModule(UIModule* module)
@@ -168,4 +964,13 @@ namespace EJV
 
         _uis.push_back(module);
     }
+
+    State::ID State::registerBlock(const BlockInfo& info)
+    {
+        ID id = blocks.add(info);
+
+        blockProperties.set(id, info.solid, info.opaque, info.randomTicks, info.replaceable, info.light);
+
+        return id;
+    }
 }
@@ -8,6 +8,8 @@ namespace EJV
     {
         _handle = dlopen(path.c_str(), RTLD_LAZY | RTLD_LOCAL);
 
+        _path = path;
+
         return _handle;
     }
 
@@ -33,6 +35,13 @@ namespace EJV
         Module::loadFunctions();
 
         tick = (TickFunc) fetchFunctionPointer("tick");
+        tickActions = (TickActionsFunc) fetchFunctionPointer("tickActions");
+        getActionMask = (GetActionMaskFunc) fetchFunctionPointer("getActionMask");
+
+        // Modules not declaring their action types get every action
+        actionMask = getActionMask ? getActionMask() : ACTION_MASK_ALL;
+
+        if (!tick && !tickActions) actionMask = 0;
     }
 
     void UIModule::loadFunctions()
@@ -49,7 +58,7 @@ namespace EJV
 
         loadChunk = (LoadChunkFunc) fetchFunctionPointer("loadChunk");
         putChunk = (PutChunkFunc) fetchFunctionPointer("putChunk");
-        releaseChunk = (ReleaseChunkFunc) fetchFunctionPointer("releaseChuk");
+        releaseChunk = (ReleaseChunkFunc) fetchFunctionPointer("releaseChunk");
 
         setWorldName = (SetWorldNameFunc) fetchFunctionPointer("setWorldName");
 
@@ -0,0 +1,49 @@
+#include "RandomTicker.hpp"
+
+#include "ChunkIndex.hpp"
+
+namespace EJV
+{
+    namespace
+    {
+        /** SplitMix64, one multiply-xorshift round per number */
+        inline uint64_t nextRandom(uint64_t& state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+            return z ^ (z >> 31);
+        }
+    }
+
+    bool RandomTicker::hasTickable(const Chunk& chunk) const
+    {
+        // Palettes may list types no block uses anymore, that only costs a few picks
+        for (unsigned int i = 0; i < chunk.getPaletteSize(); ++i)
+        {
+            if (isTickable(chunk.getPaletteEntry(i))) return true;
+        }
+
+        return false;
+    }
+
+    void RandomTicker::select(const Point3D& point, const Chunk& chunk, uint64_t tick, std::vector<Point3D>& blocks)
+    {
+        uint64_t state = _seed ^ (ChunkIndex::key(point) * 0xD6E8FEB86659FD93ull) ^ tick;
+
+        for (unsigned int i = 0; i < _speed; ++i)
+        {
+            const unsigned int index = nextRandom(state) % CHUNK_VOLUME;
+
+            if (!isTickable(chunk.getBlockAt(index))) continue;
+
+            Point3D local = Chunk::position(index);
+
+            blocks.push_back(Point3D(point.x * CHUNK_WIDTH + local.x, point.y * CHUNK_HEIGHT + local.y, point.z * CHUNK_LENGTH + local.z));
+
+            ++_stats.picked;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include "ScheduledUpdates.hpp"
+
+#include "Chunk.hpp"
+
+#include <algorithm>
+
+namespace EJV
+{
+    namespace
+    {
+        // std heaps keep the largest element on top
+        struct Later
+        {
+            bool operator()(const ScheduledUpdates::Entry& a, const ScheduledUpdates::Entry& b) const { return b < a; }
+        };
+    }
+
+    bool ScheduledUpdates::schedule(unsigned int index, uint64_t tick, int priority)
+    {
+        if (isScheduled(index)) return false;
+
+        if (_pending.empty()) _pending.assign(CHUNK_VOLUME / 64, 0);
+
+        _pending[index / 64] |= uint64_t(1) << (index % 64);
+
+        Entry entry = { tick, priority, (unsigned short) index };
+
+        _heap.push_back(entry);
+
+        std::push_heap(_heap.begin(), _heap.end(), Later());
+
+        ++_modCount;
+
+        return true;
+    }
+
+    void ScheduledUpdates::popDue(uint64_t tick, EntryList& due)
+    {
+        if (_heap.empty() || _heap.front().tick > tick) return;
+
+        while (!_heap.empty() && _heap.front().tick <= tick)
+        {
+            std::pop_heap(_heap.begin(), _heap.end(), Later());
+
+            const Entry& entry = _heap.back();
+
+            _pending[entry.index / 64] &= ~(uint64_t(1) << (entry.index % 64));
+
+            due.push_back(entry);
+
+            _heap.pop_back();
+        }
+
+        ++_modCount;
+
+        // Give the memory back once a burst of updates is over
+        if (_heap.empty())
+        {
+            EntryList().swap(_heap);
+            std::vector<uint64_t>().swap(_pending);
+        }
+    }
+
+    void ScheduledUpdates::clear()
+    {
+        if (_heap.empty()) return;
+
+        EntryList().swap(_heap);
+        std::vector<uint64_t>().swap(_pending);
+
+        ++_modCount;
+    }
+}
@@ -0,0 +1,146 @@
+#include "ThreadPool.hpp"
+#include "Tracer.hpp"
+
+namespace EJV
+{
+    ThreadPool::ThreadPool(unsigned int threads) : _active(0), _stop(false)
+    {
+        if (!threads)
+        {
+            unsigned int cores = std::thread::hardware_concurrency();
+
+            threads = cores > 1 ? cores - 1 : 1;
+        }
+
+        for (unsigned int i = 0; i < threads; ++i)
+        {
+            _threads.push_back(std::thread(&ThreadPool::work, this));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _stop = true;
+        }
+
+        _wake.notify_all();
+
+        for (std::vector<std::thread>::iterator it = _threads.begin(); it != _threads.end(); ++it)
+        {
+            it->join();
+        }
+    }
+
+    void ThreadPool::submit(const Job& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _jobs.push_back(job);
+        }
+
+        _wake.notify_one();
+    }
+
+    namespace
+    {
+        struct Batch
+        {
+            std::function<void(unsigned int)> body;
+
+            unsigned int count;
+
+            std::atomic<unsigned int> next;
+            std::atomic<unsigned int> done;
+
+            std::mutex mutex;
+
+            std::condition_variable finished;
+
+            void run()
+            {
+                unsigned int i;
+
+                while ((i = next++) < count)
+                {
+                    body(i);
+
+                    if (++done == count)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+    }
+
+    void ThreadPool::parallelFor(unsigned int count, const std::function<void(unsigned int)>& body)
+    {
+        if (!count) return;
+
+        // Helpers may start after the batch is done, so they share ownership
+        std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+
+        batch->body = body;
+        batch->count = count;
+        batch->next = 0;
+        batch->done = 0;
+
+        unsigned int helpers = count - 1 < size() ? count - 1 : size();
+
+        for (unsigned int i = 0; i < helpers; ++i)
+        {
+            submit([batch]() { batch->run(); });
+        }
+
+        // Work along instead of idling, also avoids waiting behind long jobs
+        batch->run();
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+
+        while (batch->done < count) batch->finished.wait(lock);
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (!_jobs.empty() || _active) _idle.wait(lock);
+    }
+
+    void ThreadPool::work()
+    {
+        Tracer::GET().nameThread("worker");
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (true)
+        {
+            while (_jobs.empty() && !_stop) _wake.wait(lock);
+
+            // Queued jobs still run when stopping
+            if (_jobs.empty()) return;
+
+            Job job = _jobs.front();
+
+            _jobs.pop_front();
+
+            ++_active;
+
+            lock.unlock();
+
+            job();
+
+            lock.lock();
+
+            --_active;
+
+            if (_jobs.empty() && !_active) _idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,195 @@
+#include "TickProfiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace EJV
+{
+    TickProfiler::TickProfiler(unsigned int history) : _history(history ? history : 1), _ring(new Slot[_history]),
+                                                       _head(0), _enabled(true), _phaseCount(0)
+    {
+        for (unsigned int i = 0; i < _history; ++i)
+        {
+            _ring[i].sequence.store(0, std::memory_order_relaxed);
+
+            for (unsigned int page = 0; page < MAX_PAGES; ++page) _ring[i].pages[page].store(0, std::memory_order_relaxed);
+        }
+
+        for (unsigned int page = 0; page < MAX_PAGES; ++page) _current[page].store(0, std::memory_order_relaxed);
+    }
+
+    TickProfiler::~TickProfiler()
+    {
+        for (unsigned int page = 0; page < MAX_PAGES; ++page)
+        {
+            for (unsigned int i = 0; i < _history; ++i) delete[] _ring[i].pages[page].load(std::memory_order_relaxed);
+
+            delete[] _current[page].load(std::memory_order_relaxed);
+        }
+    }
+
+    TickProfiler::Counter* TickProfiler::newPage()
+    {
+        Counter* page = new Counter[PAGE_PHASES];
+
+        for (unsigned int phase = 0; phase < PAGE_PHASES; ++phase) page[phase].store(0, std::memory_order_relaxed);
+
+        return page;
+    }
+
+    TickProfiler::PhaseID TickProfiler::getPhase(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<std::string>::const_iterator it = std::find(_names.begin(), _names.end(), name);
+
+        if (it != _names.end()) return it - _names.begin();
+
+        if (_names.size() == MAX_PHASES) throw std::runtime_error("Too many profiler phases");
+
+        // First phase of a page, published before anyone gets its ID
+        if (_names.size() % PAGE_PHASES == 0) _current[_names.size() / PAGE_PHASES].store(newPage(), std::memory_order_release);
+
+        _names.push_back(name);
+
+        _phaseCount.store(_names.size(), std::memory_order_release);
+
+        return _names.size() - 1;
+    }
+
+    std::string TickProfiler::getPhaseName(PhaseID phase) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return phase < _names.size() ? _names[phase] : std::string();
+    }
+
+    void TickProfiler::endTick()
+    {
+        const uint64_t tick = _head.load(std::memory_order_relaxed);
+
+        Slot& slot = _ring[tick % _history];
+
+        // Seqlock: odd while writing, readers retry or skip
+        slot.sequence.store(2 * tick + 1, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const unsigned int pages = (getPhaseCount() + PAGE_PHASES - 1) / PAGE_PHASES;
+
+        for (unsigned int page = 0; page < pages; ++page)
+        {
+            Counter* current = _current[page].load(std::memory_order_acquire);
+            Counter* stored = slot.pages[page].load(std::memory_order_relaxed);
+
+            if (!stored)
+            {
+                stored = newPage();
+
+                slot.pages[page].store(stored, std::memory_order_release);
+            }
+
+            for (unsigned int phase = 0; phase < PAGE_PHASES; ++phase)
+            {
+                stored[phase].store(current[phase].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+
+        slot.sequence.store(2 * tick + 2, std::memory_order_release);
+
+        _head.store(tick + 1, std::memory_order_release);
+    }
+
+    void TickProfiler::summarize(SummaryList& summaries) const
+    {
+        const unsigned int phases = getPhaseCount();
+
+        std::vector<std::vector<uint64_t> > samples(phases);
+
+        std::vector<uint64_t> frame(phases);
+
+        for (unsigned int i = 0; i < _history; ++i)
+        {
+            const Slot& slot = _ring[i];
+
+            const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+
+            if (!before || before % 2) continue;
+
+            for (unsigned int phase = 0; phase < phases; ++phase)
+            {
+                const Counter* page = slot.pages[phase / PAGE_PHASES].load(std::memory_order_acquire);
+
+                // Registered after this tick was stored
+                frame[phase] = page ? page[phase % PAGE_PHASES].load(std::memory_order_relaxed) : 0;
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Overwritten while reading
+            if (slot.sequence.load(std::memory_order_relaxed) != before) continue;
+
+            for (unsigned int phase = 0; phase < phases; ++phase) samples[phase].push_back(frame[phase]);
+        }
+
+        for (unsigned int phase = 0; phase < phases; ++phase)
+        {
+            std::vector<uint64_t>& values = samples[phase];
+
+            Summary summary = { getPhaseName(phase), (unsigned int) values.size(), 0, 0, 0, 0 };
+
+            if (!values.empty())
+            {
+                std::sort(values.begin(), values.end());
+
+                uint64_t total = 0;
+
+                for (std::vector<uint64_t>::const_iterator it = values.begin(); it != values.end(); ++it) total += *it;
+
+                summary.mean = total / 1e6 / values.size();
+                summary.p50 = values[(values.size() - 1) * 50 / 100] / 1e6;
+                summary.p99 = values[(values.size() - 1) * 99 / 100] / 1e6;
+                summary.max = values.back() / 1e6;
+            }
+
+            summaries.push_back(summary);
+        }
+    }
+
+    void TickProfiler::dump(std::ostream& out) const
+    {
+        SummaryList summaries;
+
+        summarize(summaries);
+
+        std::ios::fmtflags flags = out.flags();
+
+        out << std::left << std::setw(32) << "phase (ms per tick)" << std::right
+            << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max"
+            << std::setw(8) << "ticks" << '\n';
+
+        out << std::fixed << std::setprecision(3);
+
+        for (SummaryList::const_iterator it = summaries.begin(); it != summaries.end(); ++it)
+        {
+            out << std::left << std::setw(32) << it->name << std::right
+                << std::setw(10) << it->mean << std::setw(10) << it->p50 << std::setw(10) << it->p99 << std::setw(10) << it->max
+                << std::setw(8) << it->samples << '\n';
+        }
+
+        out.flags(flags);
+    }
+
+    bool TickProfiler::dump(const std::string& path) const
+    {
+        std::ofstream file(path.c_str());
+
+        if (!file) return false;
+
+        dump(file);
+
+        return file.good();
+    }
+}
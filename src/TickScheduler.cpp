@@ -0,0 +1,73 @@
+#include "TickScheduler.hpp"
+
+#include <thread>
+
+namespace EJV
+{
+    namespace
+    {
+        inline double toMilliseconds(TickScheduler::Clock::duration duration)
+        {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+    }
+
+    void TickScheduler::start()
+    {
+        _deadline = Clock::now();
+    }
+
+    void TickScheduler::wait()
+    {
+        Clock::time_point now = Clock::now();
+
+        // Sleeping tends to overshoot, yield through the last stretch
+        if (now < _deadline - _spinMargin) std::this_thread::sleep_until(_deadline - _spinMargin);
+
+        while ((now = Clock::now()) < _deadline) std::this_thread::yield();
+
+        _started = now;
+
+        _stats.lateness = toMilliseconds(now - _deadline);
+
+        if (_stats.lateness > _stats.maxLateness) _stats.maxLateness = _stats.lateness;
+
+        if (now - _deadline > _tolerance) ++_stats.lateTicks;
+    }
+
+    void TickScheduler::finish()
+    {
+        Clock::time_point now = Clock::now();
+
+        ++_stats.ticks;
+
+        _stats.busyTime = toMilliseconds(now - _started);
+
+        // Average over roughly the last 20 ticks
+        _stats.averageBusy += (_stats.busyTime - _stats.averageBusy) / 20;
+
+        // Unpaced, the next tick is due right away
+        if (_duration <= Clock::duration::zero())
+        {
+            _stats.overloaded = false;
+
+            _deadline = now;
+
+            return;
+        }
+
+        _stats.overloaded = _stats.averageBusy * 100 > toMilliseconds(_duration) * _overloadPercent;
+
+        _deadline += _duration;
+
+        // Too far behind, give up on the missed ticks
+        if (now - _deadline > _duration * _maxCatchUp)
+        {
+            Clock::time_point deadline = now - _duration * _maxCatchUp;
+
+            _stats.droppedTicks += (deadline - _deadline) / _duration;
+
+            _deadline = deadline;
+        }
+    }
+}
@@ -0,0 +1,213 @@
+#include "Tracer.hpp"
+
+#include <fstream>
+#include <iomanip>
+
+namespace EJV
+{
+    namespace
+    {
+        inline int64_t toNanoseconds(Tracer::Clock::duration duration)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        }
+
+        void writeString(std::ostream& out, const std::string& text)
+        {
+            out << '"';
+
+            for (std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+            {
+                switch (*it)
+                {
+                    case '"':  out << "\\\""; break;
+                    case '\\': out << "\\\\"; break;
+                    case '\n': out << "\\n"; break;
+
+                    default:
+                        if ((unsigned char) *it < 0x20) out << ' ';
+                        else out << *it;
+                }
+            }
+
+            out << '"';
+        }
+    }
+
+    Tracer* Tracer::_singleton = 0;
+
+    std::atomic<bool> Tracer::_capturing(false);
+
+    Tracer& Tracer::GET()
+    {
+        static std::once_flag created;
+
+        std::call_once(created, []() { _singleton = new Tracer; });
+
+        return *_singleton;
+    }
+
+    Tracer::Buffer& Tracer::getBuffer()
+    {
+        // Owned by the tracer, outlives the thread so its events can still be written
+        static thread_local Buffer* buffer = 0;
+
+        if (!buffer)
+        {
+            std::shared_ptr<Buffer> created = std::make_shared<Buffer>();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            created->thread = _buffers.size() + 1;
+
+            _buffers.push_back(created);
+
+            buffer = created.get();
+        }
+
+        return *buffer;
+    }
+
+    void Tracer::start(unsigned int maxEvents)
+    {
+        stop();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (std::vector<std::shared_ptr<Buffer> >::iterator it = _buffers.begin(); it != _buffers.end(); ++it)
+        {
+            std::lock_guard<std::mutex> bufferLock((*it)->mutex);
+
+            std::vector<Event>().swap((*it)->events);
+        }
+
+        _maxEvents.store(maxEvents, std::memory_order_relaxed);
+
+        _events.store(0, std::memory_order_relaxed);
+        _dropped.store(0, std::memory_order_relaxed);
+
+        _epoch.store(toNanoseconds(Clock::now().time_since_epoch()), std::memory_order_relaxed);
+
+        _capturing.store(true, std::memory_order_release);
+    }
+
+    void Tracer::stop()
+    {
+        _capturing.store(false, std::memory_order_release);
+    }
+
+    void Tracer::nameThread(const std::string& name)
+    {
+        Buffer& buffer = getBuffer();
+
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+
+        buffer.name = name;
+    }
+
+    void Tracer::record(const Scope& scope)
+    {
+        Clock::time_point end = Clock::now();
+
+        // Stopped in the meantime, acquire pairs with start() publishing the settings
+        if (!_capturing.load(std::memory_order_acquire)) return;
+
+        if (_events.fetch_add(1, std::memory_order_relaxed) >= _maxEvents.load(std::memory_order_relaxed))
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+
+            return;
+        }
+
+        Event event = { scope._name, scope._detail,
+                        toNanoseconds(scope._start.time_since_epoch()) - _epoch.load(std::memory_order_relaxed),
+                        toNanoseconds(end - scope._start),
+                        scope._point, scope._hasPoint };
+
+        Buffer& buffer = getBuffer();
+
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+
+        buffer.events.push_back(event);
+    }
+
+    void Tracer::write(std::ostream& out)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::ios::fmtflags flags = out.flags();
+
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+
+        for (std::vector<std::shared_ptr<Buffer> >::const_iterator it = _buffers.begin(); it != _buffers.end(); ++it)
+        {
+            Buffer& buffer = **it;
+
+            std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+
+            if (!buffer.name.empty())
+            {
+                out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer.thread
+                    << ",\"args\":{\"name\":";
+
+                writeString(out, buffer.name);
+
+                out << "}}";
+
+                first = false;
+            }
+
+            for (std::vector<Event>::const_iterator event = buffer.events.begin(); event != buffer.events.end(); ++event)
+            {
+                // Timestamps are in microseconds
+                out << (first ? "" : ",") << "\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.thread
+                    << ",\"ts\":" << event->start / 1000.0 << ",\"dur\":" << event->duration / 1000.0 << ",\"name\":";
+
+                writeString(out, event->name);
+
+                if (event->detail || event->hasPoint)
+                {
+                    out << ",\"args\":{";
+
+                    if (event->detail)
+                    {
+                        out << "\"detail\":";
+
+                        writeString(out, event->detail);
+                    }
+
+                    if (event->hasPoint)
+                    {
+                        out << (event->detail ? "," : "") << "\"x\":" << event->point.x << ",\"y\":" << event->point.y
+                            << ",\"z\":" << event->point.z;
+                    }
+
+                    out << '}';
+                }
+
+                out << '}';
+
+                first = false;
+            }
+        }
+
+        out << "\n]}\n";
+
+        out.flags(flags);
+    }
+
+    bool Tracer::write(const std::string& path)
+    {
+        std::ofstream file(path.c_str());
+
+        if (!file) return false;
+
+        write(file);
+
+        return file.good();
+    }
+}
@@ -0,0 +1,124 @@
+#include "UpdateWheel.hpp"
+
+#include <algorithm>
+
+namespace EJV
+{
+    void UpdateWheel::add(Key chunk, uint64_t tick)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        insert(chunk, tick);
+
+        ++_size;
+    }
+
+    void UpdateWheel::insert(Key chunk, uint64_t tick)
+    {
+        if (tick <= _now)
+        {
+            _late.push_back(chunk);
+        }
+        else if (tick >> SLOT_BITS == _now >> SLOT_BITS)
+        {
+            _near[tick % SLOTS].push_back(chunk);
+        }
+        else if (tick >> (2 * SLOT_BITS) == _now >> (2 * SLOT_BITS))
+        {
+            Timer timer = { chunk, tick };
+
+            _far[(tick >> SLOT_BITS) % SLOTS].push_back(timer);
+        }
+        else
+        {
+            _overflow.insert(std::make_pair(tick, chunk));
+        }
+    }
+
+    void UpdateWheel::advance(uint64_t tick, KeyList& due)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const size_t first = due.size();
+
+        if (tick > _now + 2 * SLOTS * SLOTS)
+        {
+            // Long jump, both wheels are entirely due
+            for (unsigned int i = 0; i < SLOTS; ++i)
+            {
+                due.insert(due.end(), _near[i].begin(), _near[i].end());
+
+                for (TimerList::const_iterator it = _far[i].begin(); it != _far[i].end(); ++it) due.push_back(it->chunk);
+
+                _near[i].clear();
+                _far[i].clear();
+            }
+
+            _now = tick;
+
+            // Bring the overflow up to the new time
+            std::multimap<uint64_t, Key>::iterator end = _overflow.lower_bound(((_now >> (2 * SLOT_BITS)) + 1) << (2 * SLOT_BITS));
+
+            for (std::multimap<uint64_t, Key>::iterator it = _overflow.begin(); it != end; ++it) insert(it->second, it->first);
+
+            _overflow.erase(_overflow.begin(), end);
+        }
+
+        while (_now < tick)
+        {
+            const uint64_t t = ++_now;
+
+            if (t % (SLOTS * SLOTS) == 0)
+            {
+                // Entering a new 65536 tick span
+                std::multimap<uint64_t, Key>::iterator end = _overflow.lower_bound(t + SLOTS * SLOTS);
+
+                for (std::multimap<uint64_t, Key>::iterator it = _overflow.begin(); it != end; ++it) insert(it->second, it->first);
+
+                _overflow.erase(_overflow.begin(), end);
+            }
+
+            if (t % SLOTS == 0)
+            {
+                // Entering a new 256 tick span
+                TimerList far;
+
+                far.swap(_far[(t >> SLOT_BITS) % SLOTS]);
+
+                for (TimerList::const_iterator it = far.begin(); it != far.end(); ++it) insert(it->chunk, it->tick);
+            }
+
+            KeyList& slot = _near[t % SLOTS];
+
+            due.insert(due.end(), slot.begin(), slot.end());
+
+            slot.clear();
+        }
+
+        due.insert(due.end(), _late.begin(), _late.end());
+
+        _late.clear();
+
+        _size -= due.size() - first;
+
+        std::sort(due.begin() + first, due.end());
+
+        due.erase(std::unique(due.begin() + first, due.end()), due.end());
+    }
+
+    void UpdateWheel::clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (unsigned int i = 0; i < SLOTS; ++i)
+        {
+            _near[i].clear();
+            _far[i].clear();
+        }
+
+        _overflow.clear();
+        _late.clear();
+
+        _size = 0;
+    }
+}
@@ -24,7 +24,7 @@ int main()
 
     standardBlocks->loadFunctions();
 
-    if (!standardBlocks->init || !standardBlocks->destroy || !standardBlocks->tick)
+    if (!standardBlocks->init || !standardBlocks->destroy)
     {
         std::cout << "Unable to load libStandardBlock.so's functions" << std::endl;
         std::cout << "Error: " << dlerror() << std::endl;
@@ -49,7 +49,8 @@ int main()
     // Reguest chunk
     //mainWorld->loadChunk(Point3D(0, 0, 0));
 
-    std::cout << "Number of registered objects: " << CORE.getNumMetadata() << std::endl;
+    std::cout << "Number of registered objects: " << CORE.blocks.size() << " blocks, " << CORE.items.size() << " items, "
+              << CORE.entities.size() << " entities" << std::endl;
 
     CORE.run();
 